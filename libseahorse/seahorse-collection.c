@@ -28,11 +28,23 @@ enum {
 	PROP_PREDICATE
 };
 
+enum {
+	OBJECTS_ADDED,
+	OBJECTS_REMOVED,
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
 struct _SeahorseCollectionPrivate {
 	GcrCollection *base;
 	GHashTable *objects;
 	SeahorsePredicate *pred;
 	GDestroyNotify destroy_func;
+
+	/* Objects added to base, not yet checked against the predicate */
+	GPtrArray *pending;
+	guint pending_idle;
 };
 
 static void      seahorse_collection_iface_init     (GcrCollectionIface *iface);
@@ -43,30 +55,64 @@ static gboolean  maybe_add_object                   (SeahorseCollection *self,
 static gboolean  maybe_remove_object                (SeahorseCollection *self,
                                                      GObject *obj);
 
+static void      flush_pending                      (SeahorseCollection *self);
+
 G_DEFINE_TYPE_WITH_CODE (SeahorseCollection, seahorse_collection, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (GCR_TYPE_COLLECTION, seahorse_collection_iface_init);
 );
 
 static void
-on_object_changed (GObject *obj,
-                   GParamSpec *spec,
-                   gpointer user_data)
+emit_objects_added (SeahorseCollection *self,
+                    GPtrArray *objects)
 {
-	SeahorseCollection *self = SEAHORSE_COLLECTION (user_data);
-	if (g_hash_table_lookup (self->pv->objects, obj))
-		maybe_remove_object (self, obj);
-	else
-		maybe_add_object (self, obj);
+	if (objects->len > 0)
+		g_signal_emit (self, signals[OBJECTS_ADDED], 0, objects);
 }
 
 static void
-remove_object (SeahorseCollection *self,
-               GObject *object)
+emit_objects_removed (SeahorseCollection *self,
+                      GPtrArray *objects)
 {
-	g_hash_table_remove (self->pv->objects, object);
-	gcr_collection_emit_removed (GCR_COLLECTION (self), object);
+	if (objects->len > 0)
+		g_signal_emit (self, signals[OBJECTS_REMOVED], 0, objects);
 }
 
+static void
+emit_object_added (SeahorseCollection *self,
+                   GObject *object)
+{
+	GPtrArray *objects = g_ptr_array_new ();
+	g_ptr_array_add (objects, object);
+	emit_objects_added (self, objects);
+	g_ptr_array_free (objects, TRUE);
+}
+
+static void
+emit_object_removed (SeahorseCollection *self,
+                     GObject *object)
+{
+	GPtrArray *objects = g_ptr_array_new ();
+	g_ptr_array_add (objects, object);
+	emit_objects_removed (self, objects);
+	g_ptr_array_free (objects, TRUE);
+}
+
+static void
+on_object_changed (GObject *obj,
+                   GParamSpec *spec,
+                   gpointer user_data)
+{
+	SeahorseCollection *self = SEAHORSE_COLLECTION (user_data);
+	if (g_hash_table_lookup (self->pv->objects, obj)) {
+		if (maybe_remove_object (self, obj))
+			emit_object_removed (self, obj);
+	} else {
+		if (maybe_add_object (self, obj))
+			emit_object_added (self, obj);
+	}
+}
+
+/* These only update the set, the callers emit the signals */
 static gboolean
 maybe_add_object (SeahorseCollection *self,
                   GObject *obj)
@@ -78,7 +124,6 @@ maybe_add_object (SeahorseCollection *self,
 		return FALSE;
 
 	g_hash_table_replace (self->pv->objects, obj, GINT_TO_POINTER (TRUE));
-	gcr_collection_emit_added (GCR_COLLECTION (self), obj);
 	return TRUE;
 }
 
@@ -92,10 +137,49 @@ maybe_remove_object (SeahorseCollection *self,
 	if (self->pv->pred && seahorse_predicate_match (self->pv->pred, obj))
 		return FALSE;
 
-	remove_object (self, obj);
+	g_hash_table_remove (self->pv->objects, obj);
 	return TRUE;
 }
 
+static void
+flush_pending (SeahorseCollection *self)
+{
+	GPtrArray *pending;
+	GPtrArray *added;
+	guint i;
+
+	if (self->pv->pending_idle) {
+		g_source_remove (self->pv->pending_idle);
+		self->pv->pending_idle = 0;
+	}
+
+	if (self->pv->pending->len == 0)
+		return;
+
+	/* Objects may be added to base while we emit */
+	pending = self->pv->pending;
+	self->pv->pending = g_ptr_array_new ();
+
+	added = g_ptr_array_new ();
+	for (i = 0; i < pending->len; i++) {
+		if (maybe_add_object (self, pending->pdata[i]))
+			g_ptr_array_add (added, pending->pdata[i]);
+	}
+
+	emit_objects_added (self, added);
+	g_ptr_array_free (added, TRUE);
+	g_ptr_array_free (pending, TRUE);
+}
+
+static gboolean
+on_pending_idle (gpointer user_data)
+{
+	SeahorseCollection *self = SEAHORSE_COLLECTION (user_data);
+	self->pv->pending_idle = 0;
+	flush_pending (self);
+	return FALSE;
+}
+
 static void
 on_base_added (GcrCollection *base,
                GObject *obj,
@@ -104,7 +188,15 @@ on_base_added (GcrCollection *base,
 	SeahorseCollection *self = SEAHORSE_COLLECTION (user_data);
 
 	g_signal_connect (obj, "notify", G_CALLBACK (on_object_changed), self);
-	maybe_add_object (self, obj);
+
+	/*
+	 * Places add their objects one by one while loading. Collect them
+	 * and add them in one go, before anything gets drawn.
+	 */
+	g_ptr_array_add (self->pv->pending, obj);
+	if (!self->pv->pending_idle)
+		self->pv->pending_idle = g_idle_add_full (G_PRIORITY_HIGH_IDLE, on_pending_idle,
+		                                          self, NULL);
 }
 
 static void
@@ -116,8 +208,11 @@ on_base_removed (GcrCollection *base,
 
 	g_signal_handlers_disconnect_by_func (object, on_object_changed, self);
 
-	if (g_hash_table_lookup (self->pv->objects, object))
-		remove_object (self, object);
+	if (g_ptr_array_remove (self->pv->pending, object))
+		return;
+
+	if (g_hash_table_remove (self->pv->objects, object))
+		emit_object_removed (self, object);
 }
 
 static void
@@ -138,17 +233,25 @@ seahorse_collection_init (SeahorseCollection *self)
 	self->pv = G_TYPE_INSTANCE_GET_PRIVATE (self, SEAHORSE_TYPE_COLLECTION,
 	                                        SeahorseCollectionPrivate);
 	self->pv->objects = g_hash_table_new (g_direct_hash, g_direct_equal);
+	self->pv->pending = g_ptr_array_new ();
 }
 
 static void
 seahorse_collection_constructed (GObject *obj)
 {
 	SeahorseCollection *self = SEAHORSE_COLLECTION (obj);
+	GList *l, *objects;
 
 	g_return_if_fail (self->pv->base);
 
 	G_OBJECT_CLASS (seahorse_collection_parent_class)->constructed (obj);
 
+	/* Every base object is watched once, from here or when it's added */
+	objects = gcr_collection_get_objects (self->pv->base);
+	for (l = objects; l != NULL; l = g_list_next (l))
+		g_signal_connect (l->data, "notify", G_CALLBACK (on_object_changed), self);
+	g_list_free (objects);
+
 	g_signal_connect (self->pv->base, "added", G_CALLBACK (on_base_added), self);
 	g_signal_connect (self->pv->base, "removed", G_CALLBACK (on_base_removed), self);
 }
@@ -158,18 +261,31 @@ seahorse_collection_dispose (GObject *obj)
 {
 	SeahorseCollection *self = SEAHORSE_COLLECTION (obj);
 	GHashTableIter iter;
+	GPtrArray *removed;
 	GObject *object;
+	GList *l, *objects;
 
 	g_signal_handlers_disconnect_by_func (self->pv->base, on_base_added, self);
 	g_signal_handlers_disconnect_by_func (self->pv->base, on_base_removed, self);
 
+	objects = gcr_collection_get_objects (self->pv->base);
+	for (l = objects; l != NULL; l = g_list_next (l))
+		g_signal_handlers_disconnect_by_func (l->data, on_object_changed, self);
+	g_list_free (objects);
+
+	if (self->pv->pending_idle)
+		g_source_remove (self->pv->pending_idle);
+	self->pv->pending_idle = 0;
+	g_ptr_array_set_size (self->pv->pending, 0);
+
+	removed = g_ptr_array_new ();
 	g_hash_table_iter_init (&iter, self->pv->objects);
-	while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL)) {
-		g_signal_handlers_disconnect_by_func (object, on_object_changed, self);
-		gcr_collection_emit_removed (GCR_COLLECTION (self), object);
-	}
+	while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL))
+		g_ptr_array_add (removed, object);
 
 	g_hash_table_remove_all (self->pv->objects);
+	emit_objects_removed (self, removed);
+	g_ptr_array_free (removed, TRUE);
 
 	G_OBJECT_CLASS (seahorse_collection_parent_class)->dispose (obj);
 }
@@ -181,6 +297,7 @@ seahorse_collection_finalize (GObject *obj)
 
 	g_clear_object (&self->pv->base);
 	g_hash_table_destroy (self->pv->objects);
+	g_ptr_array_free (self->pv->pending, TRUE);
 
 	if (self->pv->destroy_func)
 		(self->pv->destroy_func) (self->pv->pred);
@@ -238,11 +355,34 @@ seahorse_collection_get_property (GObject *obj,
 	}
 }
 
+static void
+seahorse_collection_real_objects_added (SeahorseCollection *self,
+                                        GPtrArray *objects)
+{
+	guint i;
+
+	for (i = 0; i < objects->len; i++)
+		gcr_collection_emit_added (GCR_COLLECTION (self), objects->pdata[i]);
+}
+
+static void
+seahorse_collection_real_objects_removed (SeahorseCollection *self,
+                                          GPtrArray *objects)
+{
+	guint i;
+
+	for (i = 0; i < objects->len; i++)
+		gcr_collection_emit_removed (GCR_COLLECTION (self), objects->pdata[i]);
+}
+
 static void
 seahorse_collection_class_init (SeahorseCollectionClass *klass)
 {
 	GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
+	klass->objects_added = seahorse_collection_real_objects_added;
+	klass->objects_removed = seahorse_collection_real_objects_removed;
+
 	gobject_class->constructed = seahorse_collection_constructed;
 	gobject_class->dispose = seahorse_collection_dispose;
 	gobject_class->finalize = seahorse_collection_finalize;
@@ -258,6 +398,20 @@ seahorse_collection_class_init (SeahorseCollectionClass *klass)
 	          g_param_spec_pointer ("predicate", "Predicate", "Predicate for matching objects into this set.",
 	                                G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
+	/*
+	 * The default handlers emit GcrCollection::added or ::removed for
+	 * each object. Connect with G_CONNECT_AFTER to run after all of them.
+	 */
+	signals[OBJECTS_ADDED] = g_signal_new ("objects-added", SEAHORSE_TYPE_COLLECTION,
+	                                       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (SeahorseCollectionClass, objects_added),
+	                                       NULL, NULL, g_cclosure_marshal_VOID__BOXED,
+	                                       G_TYPE_NONE, 1, G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+	signals[OBJECTS_REMOVED] = g_signal_new ("objects-removed", SEAHORSE_TYPE_COLLECTION,
+	                                         G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (SeahorseCollectionClass, objects_removed),
+	                                         NULL, NULL, g_cclosure_marshal_VOID__BOXED,
+	                                         G_TYPE_NONE, 1, G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
+
 	g_type_class_add_private (klass, sizeof (SeahorseCollectionPrivate));
 }
 
@@ -265,6 +419,7 @@ static guint
 seahorse_collection_get_length (GcrCollection *collection)
 {
 	SeahorseCollection *self = SEAHORSE_COLLECTION (collection);
+	flush_pending (self);
 	return g_hash_table_size (self->pv->objects);
 }
 
@@ -274,6 +429,7 @@ seahorse_collection_get_objects (GcrCollection *collection)
 	SeahorseCollection *self = SEAHORSE_COLLECTION (collection);
 	GList *objs = NULL;
 
+	flush_pending (self);
 	g_hash_table_foreach (self->pv->objects, (GHFunc)objects_to_list, &objs);
 
 	return objs;
@@ -284,6 +440,7 @@ seahorse_collection_contains (GcrCollection *collection,
                               GObject *object)
 {
 	SeahorseCollection *self = SEAHORSE_COLLECTION (collection);
+	flush_pending (self);
 	return g_hash_table_lookup (self->pv->objects, object) ? TRUE : FALSE;
 }
 
@@ -318,11 +475,16 @@ seahorse_collection_refresh (SeahorseCollection *self)
 {
 	GHashTable *check = g_hash_table_new (g_direct_hash, g_direct_equal);
 	GList *l, *objects = NULL;
+	GPtrArray *added, *removed;
 	GHashTableIter iter;
 	GObject *obj;
 
 	g_return_if_fail (SEAHORSE_IS_COLLECTION (self));
 
+	flush_pending (self);
+	added = g_ptr_array_new ();
+	removed = g_ptr_array_new ();
+
 	/* Make note of all the objects we had prior to refresh */
 	g_hash_table_foreach (self->pv->objects, (GHFunc)objects_to_hash, check);
 
@@ -333,20 +495,85 @@ seahorse_collection_refresh (SeahorseCollection *self)
 		g_hash_table_remove (check, l->data);
 
 		/* This will add to set */
-		if (!maybe_remove_object (self, l->data)) {
-			if (maybe_add_object (self, l->data))
-				g_signal_connect (l->data, "notify", G_CALLBACK (on_object_changed), self);
-		}
+		if (maybe_remove_object (self, l->data))
+			g_ptr_array_add (removed, l->data);
+		else if (maybe_add_object (self, l->data))
+			g_ptr_array_add (added, l->data);
 	}
 	g_list_free (objects);
 
 	g_hash_table_iter_init (&iter, check);
 	while (g_hash_table_iter_next (&iter, (gpointer *)&obj, NULL)) {
-		g_signal_handlers_disconnect_by_func (obj, on_object_changed, self);
-		remove_object (self, obj);
+		g_hash_table_remove (self->pv->objects, obj);
+		g_ptr_array_add (removed, obj);
 	}
 
 	g_hash_table_destroy (check);
+
+	emit_objects_removed (self, removed);
+	emit_objects_added (self, added);
+	g_ptr_array_free (removed, TRUE);
+	g_ptr_array_free (added, TRUE);
+}
+
+/**
+ * seahorse_collection_refresh_narrowed:
+ * @self: the collection
+ *
+ * Refresh the collection after the predicate has become stricter, so
+ * that nothing outside the collection could start matching. Only the
+ * objects currently in the collection are checked again.
+ */
+void
+seahorse_collection_refresh_narrowed (SeahorseCollection *self)
+{
+	GList *l, *objects;
+	GPtrArray *removed;
+
+	g_return_if_fail (SEAHORSE_IS_COLLECTION (self));
+
+	flush_pending (self);
+	removed = g_ptr_array_new ();
+
+	objects = g_hash_table_get_keys (self->pv->objects);
+	for (l = objects; l != NULL; l = g_list_next (l)) {
+		if (maybe_remove_object (self, l->data))
+			g_ptr_array_add (removed, l->data);
+	}
+	g_list_free (objects);
+
+	emit_objects_removed (self, removed);
+	g_ptr_array_free (removed, TRUE);
+}
+
+/**
+ * seahorse_collection_refresh_widened:
+ * @self: the collection
+ *
+ * Refresh the collection after the predicate has become looser, so
+ * that everything in the collection still matches. Only the objects
+ * of the base collection that were left out are checked again.
+ */
+void
+seahorse_collection_refresh_widened (SeahorseCollection *self)
+{
+	GList *l, *objects;
+	GPtrArray *added;
+
+	g_return_if_fail (SEAHORSE_IS_COLLECTION (self));
+
+	flush_pending (self);
+	added = g_ptr_array_new ();
+
+	objects = gcr_collection_get_objects (self->pv->base);
+	for (l = objects; l != NULL; l = g_list_next (l)) {
+		if (maybe_add_object (self, l->data))
+			g_ptr_array_add (added, l->data);
+	}
+	g_list_free (objects);
+
+	emit_objects_added (self, added);
+	g_ptr_array_free (added, TRUE);
 }
 
 SeahorsePredicate *
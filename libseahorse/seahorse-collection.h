@@ -45,6 +45,14 @@ struct _SeahorseCollection {
 
 struct _SeahorseCollectionClass {
 	GObjectClass parent_class;
+
+	/*< signals >*/
+
+	void (*objects_added)   (SeahorseCollection *self,
+	                         GPtrArray *objects);
+
+	void (*objects_removed) (SeahorseCollection *self,
+	                         GPtrArray *objects);
 };
 
 GType                seahorse_collection_get_type             (void);
@@ -57,4 +65,8 @@ SeahorsePredicate *  seahorse_collection_get_predicate        (SeahorseCollectio
 
 void                 seahorse_collection_refresh              (SeahorseCollection *self);
 
+void                 seahorse_collection_refresh_narrowed     (SeahorseCollection *self);
+
+void                 seahorse_collection_refresh_widened      (SeahorseCollection *self);
+
 #endif /* __SEAHORSE_COLLECTION_H__ */
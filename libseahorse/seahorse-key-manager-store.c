@@ -26,6 +26,8 @@
 
 #include "seahorse-key-manager-store.h"
 #include "seahorse-prefs.h"
+#include "seahorse-search-index.h"
+#include "seahorse-trigram-index.h"
 #include "seahorse-validity.h"
 #include "seahorse-util.h"
 
@@ -89,64 +91,38 @@ struct _SeahorseKeyManagerStorePriv {
     SeahorseKeyManagerStoreMode    filter_mode;
     gchar*                  filter_text;
     guint                   filter_stag;
+    gchar*                  applied_text;
+    SeahorseTrigramIndex*   index;
+    GHashTable*             candidates;
 
 	gchar *drag_destination;
 	GError *drag_error;
 	GList *drag_objects;
+
+	/* Sort order put aside while a batch of rows is inserted */
+	gboolean sort_suspended;
+	gint suspended_column;
+	GtkSortType suspended_order;
 };
 
 G_DEFINE_TYPE (SeahorseKeyManagerStore, seahorse_key_manager_store, GCR_TYPE_COLLECTION_MODEL);
 
-/* Search through row for text */
-static gboolean
-object_contains_filtered_text (GObject *object,
-                               const gchar* text)
-{
-	gchar* name = NULL;
-	gchar* description = NULL;
-	gchar* lower;
-	gboolean ret = FALSE;
-
-	/* Empty search text results in a match */
-	if (!text || !text[0])
-		return TRUE;
-
-	g_object_get (object, "label", &name, NULL);
-	if (name != NULL) {
-		lower = g_utf8_strdown (name, -1);
-		if (strstr (lower, text))
-			ret = TRUE;
-		g_free (lower);
-		g_free (name);
-	}
-
-	if (!ret && g_object_class_find_property (G_OBJECT_GET_CLASS (object), "description")) {
-		g_object_get (object, "description", &description, NULL);
-		if (description != NULL) {
-			lower = g_utf8_strdown (description, -1);
-			if (strstr (lower, text))
-				ret = TRUE;
-			g_free (lower);
-			g_free (description);
-		}
-	}
-
-	return ret;
-}
-
 /* Called to filter each row */
 static gboolean
 on_filter_visible (GObject *obj,
                    gpointer user_data)
 {
 	SeahorseKeyManagerStore* self = SEAHORSE_KEY_MANAGER_STORE (user_data);
-	GList *children, *l;
 	gboolean ret = FALSE;
 
 	/* Check the row requested */
 	switch (self->priv->filter_mode) {
 	case KEY_STORE_MODE_FILTERED:
-		ret = object_contains_filtered_text (obj, self->priv->filter_text);
+		/* Also looks through the children of collections */
+		if (self->priv->candidates && !g_hash_table_contains (self->priv->candidates, obj))
+			ret = FALSE;
+		else
+			ret = seahorse_search_index_match (obj, self->priv->filter_text);
 		break;
 
 	case KEY_STORE_MODE_ALL:
@@ -158,21 +134,46 @@ on_filter_visible (GObject *obj,
 		break;
 	};
 
-	/* If current is not being shown, double check with children */
-	if (!ret && GCR_IS_COLLECTION (obj)) {
-		children = gcr_collection_get_objects (GCR_COLLECTION (obj));
-		for (l = children; !ret && l != NULL; l = g_list_next (l))
-			ret = on_filter_visible (l->data, user_data);
-	}
-
 	return ret;
 }
 
+/* The text currently being matched, empty when everything is shown */
+static const gchar *
+current_filter_text (SeahorseKeyManagerStore *self)
+{
+	if (self->priv->filter_mode == KEY_STORE_MODE_FILTERED && self->priv->filter_text)
+		return self->priv->filter_text;
+	return "";
+}
+
+/* Narrow down which objects need their text checked during a refresh */
+static void
+prepare_candidates (SeahorseKeyManagerStore *self)
+{
+	const gchar *text = current_filter_text (self);
+	if (self->priv->index && text[0])
+		self->priv->candidates = seahorse_trigram_index_candidates (self->priv->index, text);
+}
+
+static void
+clear_candidates (SeahorseKeyManagerStore *self)
+{
+	if (self->priv->candidates)
+		g_hash_table_destroy (self->priv->candidates);
+	self->priv->candidates = NULL;
+}
+
 void
 seahorse_key_manager_store_refilter (SeahorseKeyManagerStore* self)
 {
 	GcrCollection *collection = gcr_collection_model_get_collection (GCR_COLLECTION_MODEL (self));
+
+	prepare_candidates (self);
 	seahorse_collection_refresh (SEAHORSE_COLLECTION (collection));
+	clear_candidates (self);
+
+	g_free (self->priv->applied_text);
+	self->priv->applied_text = g_strdup (current_filter_text (self));
 }
 
 /* Refilter the tree */
@@ -180,8 +181,35 @@ static gboolean
 refilter_now (gpointer user_data)
 {
 	SeahorseKeyManagerStore* self = SEAHORSE_KEY_MANAGER_STORE (user_data);
+	GcrCollection *collection;
+	const gchar *applied;
+	const gchar *text;
+
 	self->priv->filter_stag = 0;
-	seahorse_key_manager_store_refilter (self);
+	applied = self->priv->applied_text;
+	text = current_filter_text (self);
+
+	/* Nothing applied yet, or the text was replaced, so check everything */
+	if (applied == NULL || (!strstr (text, applied) && !strstr (applied, text))) {
+		seahorse_key_manager_store_refilter (self);
+		return FALSE;
+	}
+
+	collection = gcr_collection_model_get_collection (GCR_COLLECTION_MODEL (self));
+
+	/*
+	 * Anything matching the new text also matched the old text when it
+	 * was extended, and the other way around when text was deleted.
+	 */
+	prepare_candidates (self);
+	if (strstr (text, applied))
+		seahorse_collection_refresh_narrowed (SEAHORSE_COLLECTION (collection));
+	else
+		seahorse_collection_refresh_widened (SEAHORSE_COLLECTION (collection));
+	clear_candidates (self);
+
+	g_free (self->priv->applied_text);
+	self->priv->applied_text = g_strdup (text);
 	return FALSE;
 }
 
@@ -259,6 +287,57 @@ on_sort_column_changed (GtkTreeSortable *sort,
 	}
 }
 
+/*
+ * Inserting rows into a sorted model places each one separately. When a
+ * batch is at least as large as the rows already present, append the rows
+ * unsorted and then sort them all in one pass. The view stays attached and
+ * sees a single reorder, so its scroll position, cursor and selection stay.
+ */
+static void
+on_objects_added_begin (SeahorseCollection *collection,
+                        GPtrArray *objects,
+                        gpointer user_data)
+{
+	SeahorseKeyManagerStore *self = SEAHORSE_KEY_MANAGER_STORE (user_data);
+	GtkTreeSortable *sortable = GTK_TREE_SORTABLE (self);
+	gint column;
+	GtkSortType order;
+
+	if (self->priv->sort_suspended)
+		return;
+	if (objects->len < (guint)gtk_tree_model_iter_n_children (GTK_TREE_MODEL (self), NULL))
+		return;
+	if (!gtk_tree_sortable_get_sort_column_id (sortable, &column, &order))
+		return;
+
+	self->priv->sort_suspended = TRUE;
+	self->priv->suspended_column = column;
+	self->priv->suspended_order = order;
+
+	/* Not a change the user made, so don't save it */
+	g_signal_handlers_block_by_func (self, on_sort_column_changed, self);
+	gtk_tree_sortable_set_sort_column_id (sortable, GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID, order);
+	g_signal_handlers_unblock_by_func (self, on_sort_column_changed, self);
+}
+
+static void
+on_objects_added_end (SeahorseCollection *collection,
+                      GPtrArray *objects,
+                      gpointer user_data)
+{
+	SeahorseKeyManagerStore *self = SEAHORSE_KEY_MANAGER_STORE (user_data);
+
+	if (!self->priv->sort_suspended)
+		return;
+
+	self->priv->sort_suspended = FALSE;
+	g_signal_handlers_block_by_func (self, on_sort_column_changed, self);
+	gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (self),
+	                                      self->priv->suspended_column,
+	                                      self->priv->suspended_order);
+	g_signal_handlers_unblock_by_func (self, on_sort_column_changed, self);
+}
+
 /* The following three functions taken from bugzilla
  * (http://bugzilla.gnome.org/attachment.cgi?id=49362&action=view)
  * Author: Christian Neumair
@@ -536,8 +615,8 @@ seahorse_key_manager_store_set_property (GObject *gobject, guint prop_id,
             skstore->priv->filter_mode = KEY_STORE_MODE_FILTERED;
             g_free (skstore->priv->filter_text);
 
-            /* We always use lower case text (see filter_callback) */
-            skstore->priv->filter_text = g_utf8_strdown (t, -1);
+            /* We always use folded text (see on_filter_visible) */
+            skstore->priv->filter_text = seahorse_search_index_fold (t);
             refilter_later (skstore);
         }
         break;
@@ -556,6 +635,8 @@ seahorse_key_manager_store_finalize (GObject *gobject)
 
     /* Allocated in property setter */
     g_free (skstore->priv->filter_text);
+    g_free (skstore->priv->applied_text);
+    seahorse_trigram_index_free (skstore->priv->index);
 
     G_OBJECT_CLASS (seahorse_key_manager_store_parent_class)->finalize (gobject);
 }
@@ -618,12 +699,19 @@ seahorse_key_manager_store_new (GcrCollection *collection,
 	pred->custom_target = self;
 	g_object_unref (filtered);
 
+	self->priv->index = seahorse_trigram_index_new (collection);
+
 	last = gcr_collection_model_set_columns (GCR_COLLECTION_MODEL (self), columns);
 	g_return_val_if_fail (last == N_COLS, NULL);
 
 	/* The sorted model is the top level model */
 	gtk_tree_view_set_model (view, GTK_TREE_MODEL (self));
 
+	g_signal_connect_object (filtered, "objects-added",
+	                         G_CALLBACK (on_objects_added_begin), self, 0);
+	g_signal_connect_object (filtered, "objects-added",
+	                         G_CALLBACK (on_objects_added_end), self, G_CONNECT_AFTER);
+
 	/* add the icon column */
 	renderer = gtk_cell_renderer_pixbuf_new ();
 	g_object_set (renderer, "stock-size", GTK_ICON_SIZE_DND, NULL);
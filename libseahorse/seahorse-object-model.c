@@ -40,6 +40,8 @@ static guint signals[LAST_SIGNAL] = { 0 };
 typedef struct _SeahorseObjectModelPrivate {
     GHashTable *rows;
     gint data_column;
+    GHashTable *changed;        /* Objects whose rows need updating */
+    guint changed_idle;
 } SeahorseObjectModelPrivate;
 
 G_DEFINE_TYPE (SeahorseObjectModel, seahorse_object_model, GTK_TYPE_TREE_STORE);
@@ -62,8 +64,8 @@ typedef struct {
  */
 
 static void
-key_notify (GObject *object,
-            SeahorseObjectModel *self)
+update_rows (SeahorseObjectModel *self,
+             GObject *object)
 {
     SeahorseObjectModelPrivate *pv = SEAHORSE_OBJECT_MODEL_GET_PRIVATE (self);
     SeahorseObjectRow *skrow;
@@ -86,11 +88,47 @@ key_notify (GObject *object,
     }
 }
 
+static gboolean
+on_changed_idle (gpointer user_data)
+{
+    SeahorseObjectModel *self = SEAHORSE_OBJECT_MODEL (user_data);
+    SeahorseObjectModelPrivate *pv = SEAHORSE_OBJECT_MODEL_GET_PRIVATE (self);
+    GHashTableIter iter;
+    GHashTable *changed;
+    GObject *object;
+
+    pv->changed_idle = 0;
+
+    /* Updating a row may cause more notifications */
+    changed = pv->changed;
+    pv->changed = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    g_hash_table_iter_init (&iter, changed);
+    while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL))
+        update_rows (self, object);
+
+    g_hash_table_destroy (changed);
+    return FALSE;
+}
+
+/* Rows are updated once per main loop iteration, however often objects notify */
+static void
+key_notify (GObject *object,
+            SeahorseObjectModel *self)
+{
+    SeahorseObjectModelPrivate *pv = SEAHORSE_OBJECT_MODEL_GET_PRIVATE (self);
+
+    g_hash_table_add (pv->changed, object);
+    if (!pv->changed_idle)
+        pv->changed_idle = g_idle_add_full (G_PRIORITY_HIGH_IDLE, on_changed_idle, self, NULL);
+}
+
 static void
 key_destroyed (gpointer data, GObject *was)
 {
 	SeahorseObjectModelPrivate *pv = SEAHORSE_OBJECT_MODEL_GET_PRIVATE (data);
 	SeahorseObjectRow *skrow = g_hash_table_lookup (pv->rows, was);
+	g_hash_table_remove (pv->changed, was);
 	if (skrow) {
 		skrow->object = NULL;
 		skrow->binding = NULL;
@@ -185,6 +223,7 @@ seahorse_object_model_init (SeahorseObjectModel *self)
     pv->rows = g_hash_table_new_full (g_direct_hash, g_direct_equal,
                                       NULL, (GDestroyNotify)key_row_free);
     pv->data_column = -1;
+    pv->changed = g_hash_table_new (g_direct_hash, g_direct_equal);
     g_signal_connect (self, "row-inserted", G_CALLBACK (row_inserted), NULL);
 }
 
@@ -224,6 +263,10 @@ seahorse_object_model_dispose (GObject *gobject)
     SeahorseObjectModelPrivate *pv = SEAHORSE_OBJECT_MODEL_GET_PRIVATE (self);
     
     /* Release all our pointers and stuff */
+    if (pv->changed_idle)
+        g_source_remove (pv->changed_idle);
+    pv->changed_idle = 0;
+    g_hash_table_remove_all (pv->changed);
     g_hash_table_foreach_remove (pv->rows, (GHRFunc)remove_each, self);
     G_OBJECT_CLASS (seahorse_object_model_parent_class)->dispose (gobject);
 }
@@ -237,6 +280,7 @@ seahorse_object_model_finalize (GObject *gobject)
     if (pv->rows)
         g_hash_table_destroy (pv->rows);
     pv->rows = NULL;
+    g_hash_table_destroy (pv->changed);
     
     G_OBJECT_CLASS (seahorse_object_model_parent_class)->finalize (gobject);
 }
@@ -364,8 +408,9 @@ seahorse_object_model_set_row_object (SeahorseObjectModel *self,
     gtk_tree_store_set (GTK_TREE_STORE (self), iter, 
                         pv->data_column, object ? skrow : NULL, -1);
     
+    /* New rows are filled in right away */
     if (object)
-        key_notify (object, self);
+        update_rows (self, object);
 }
 
 GObject *
@@ -414,6 +459,7 @@ seahorse_object_model_remove_rows_for_object (SeahorseObjectModel *self,
     
     /* We no longer have rows associated with this key, then remove */
     g_hash_table_remove (pv->rows, object);
+    g_hash_table_remove (pv->changed, object);
 }
 
 GList*
@@ -30,6 +30,13 @@
 
 #include <glib/gi18n.h>
 
+/* set_property() notifies itself, and only when a value changes */
+#if GLIB_CHECK_VERSION (2, 42, 0)
+#define OBJECT_PARAM_FLAGS (G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY)
+#else
+#define OBJECT_PARAM_FLAGS (G_PARAM_READWRITE)
+#endif
+
 enum {
 	PROP_0,
 	PROP_PLACE,
@@ -304,6 +311,7 @@ seahorse_object_set_property (GObject *obj, guint prop_id, const GValue *value,
 {
 	SeahorseObject *self = SEAHORSE_OBJECT (obj);
 	SeahorseUsage usage;
+	GIcon *icon;
 	guint flags;
 
 	switch (prop_id) {
@@ -311,8 +319,11 @@ seahorse_object_set_property (GObject *obj, guint prop_id, const GValue *value,
 		seahorse_object_set_place (self, g_value_get_object (value));
 		break;
 	case PROP_ACTIONS:
-		g_clear_object (&self->pv->actions);
-		self->pv->actions = g_value_dup_object (value);
+		if (g_value_get_object (value) != (GObject *)self->pv->actions) {
+			g_clear_object (&self->pv->actions);
+			self->pv->actions = g_value_dup_object (value);
+			g_object_notify (obj, "actions");
+		}
 		break;
 	case PROP_LABEL:
 		if (set_string_storage (g_value_get_string (value), &self->pv->label)) {
@@ -335,8 +346,12 @@ seahorse_object_set_property (GObject *obj, guint prop_id, const GValue *value,
 		}
 		break;
 	case PROP_ICON:
+		icon = g_value_get_object (value);
+		if (icon == self->pv->icon ||
+		    (icon && self->pv->icon && g_icon_equal (icon, self->pv->icon)))
+			break;
 		g_clear_object (&self->pv->icon);
-		self->pv->icon = g_value_dup_object (value);
+		self->pv->icon = icon ? g_object_ref (icon) : NULL;
 		g_object_notify (obj, "icon");
 		break;
 	case PROP_IDENTIFIER:
@@ -389,39 +404,39 @@ seahorse_object_class_init (SeahorseObjectClass *klass)
 
 	g_object_class_install_property (gobject_class, PROP_PLACE,
 	           g_param_spec_object ("place", "Object Place", "Place the Object came from",
-	                                SEAHORSE_TYPE_PLACE, G_PARAM_READWRITE));
+	                                SEAHORSE_TYPE_PLACE, OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_ACTIONS,
 	           g_param_spec_object ("actions", "Actions", "Actions for the object",
-	                                GTK_TYPE_ACTION_GROUP, G_PARAM_READWRITE));
+	                                GTK_TYPE_ACTION_GROUP, OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_LABEL,
 	           g_param_spec_string ("label", "Object Display Label", "This object's displayable label.", 
-	                                "", G_PARAM_READWRITE));
+	                                "", OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_NICKNAME,
 	           g_param_spec_string ("nickname", "Object Short Name", "This object's short name.", 
-	                                "", G_PARAM_READWRITE));
+	                                "", OBJECT_PARAM_FLAGS));
 	
 	g_object_class_install_property (gobject_class, PROP_ICON,
 	           g_param_spec_object ("icon", "Object Icon", "Stock ID for object.",
-	                                G_TYPE_ICON, G_PARAM_READWRITE));
+	                                G_TYPE_ICON, OBJECT_PARAM_FLAGS));
 	
 	g_object_class_install_property (gobject_class, PROP_MARKUP,
 	           g_param_spec_string ("markup", "Object Display Markup", "This object's displayable markup.", 
-	                                "", G_PARAM_READWRITE));
+	                                "", OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_IDENTIFIER,
 	           g_param_spec_string ("identifier", "Object Identifier", "Displayable ID for the object.", 
-	                                "", G_PARAM_READWRITE));
+	                                "", OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_USAGE,
 	           g_param_spec_enum ("usage", "Object Usage", "How this object is used.", 
-	                              SEAHORSE_TYPE_USAGE, SEAHORSE_USAGE_NONE, G_PARAM_READWRITE));
+	                              SEAHORSE_TYPE_USAGE, SEAHORSE_USAGE_NONE, OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_FLAGS,
 	           g_param_spec_uint ("object-flags", "Object Flags", "This object's flags.",
-	                              0, G_MAXUINT, 0, G_PARAM_READWRITE));
+	                              0, G_MAXUINT, 0, OBJECT_PARAM_FLAGS));
 
 	g_object_class_install_property (gobject_class, PROP_DELETABLE,
 	           g_param_spec_boolean ("deletable", "Deletable", "Object is deletable.",
@@ -30,6 +30,76 @@
 
 #include <glib/gi18n.h>
 
+/*
+ * Objects that are not a SeahorseObject (such as secret items and
+ * certificates) may still have these properties. Look them up once
+ * per type rather than by name for every object.
+ */
+typedef struct {
+	GParamSpec *usage;
+	GParamSpec *flags;
+} PredicateProps;
+
+static const PredicateProps *
+lookup_predicate_props (GObject *obj)
+{
+	static GHashTable *props_by_type = NULL;
+	GType type = G_OBJECT_TYPE (obj);
+	PredicateProps *props;
+
+	if (props_by_type == NULL)
+		props_by_type = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+
+	props = g_hash_table_lookup (props_by_type, GSIZE_TO_POINTER (type));
+	if (props == NULL) {
+		props = g_new0 (PredicateProps, 1);
+		props->usage = g_object_class_find_property (G_OBJECT_GET_CLASS (obj), "usage");
+		props->flags = g_object_class_find_property (G_OBJECT_GET_CLASS (obj), "object-flags");
+		g_hash_table_insert (props_by_type, GSIZE_TO_POINTER (type), props);
+	}
+
+	return props;
+}
+
+static guint
+get_property_as_uint (GObject *obj,
+                      GParamSpec *spec)
+{
+	GValue value = G_VALUE_INIT;
+	guint result = 0;
+
+	if (spec == NULL)
+		return 0;
+
+	g_value_init (&value, spec->value_type);
+	g_object_get_property (obj, spec->name, &value);
+	if (G_VALUE_HOLDS_ENUM (&value))
+		result = g_value_get_enum (&value);
+	else if (G_VALUE_HOLDS_FLAGS (&value))
+		result = g_value_get_flags (&value);
+	else if (G_VALUE_HOLDS_UINT (&value))
+		result = g_value_get_uint (&value);
+	g_value_unset (&value);
+
+	return result;
+}
+
+static SeahorseUsage
+predicate_get_usage (GObject *obj)
+{
+	if (SEAHORSE_IS_OBJECT (obj))
+		return seahorse_object_get_usage (SEAHORSE_OBJECT (obj));
+	return get_property_as_uint (obj, lookup_predicate_props (obj)->usage);
+}
+
+static SeahorseFlags
+predicate_get_flags (GObject *obj)
+{
+	if (SEAHORSE_IS_OBJECT (obj))
+		return seahorse_object_get_flags (SEAHORSE_OBJECT (obj));
+	return get_property_as_uint (obj, lookup_predicate_props (obj)->flags);
+}
+
 /**
  * seahorse_predicate_match:
  * @self: the object to test
@@ -51,15 +121,12 @@ seahorse_predicate_match (SeahorsePredicate *pred,
 		return FALSE;
 
 	if (pred->usage != 0) {
-		SeahorseUsage usage = 0;
-		g_object_get (obj, "usage", &usage, NULL);
-		if (pred->usage != usage)
+		if (pred->usage != predicate_get_usage (obj))
 			return FALSE;
 	}
 
 	if (pred->flags != 0 || pred->nflags != 0) {
-		SeahorseFlags flags = 0;
-		g_object_get (obj, "object-flags", &flags, NULL);
+		SeahorseFlags flags = predicate_get_flags (obj);
 		if (pred->flags != 0 && (pred->flags & flags) == 0)
 			return FALSE;
 		if (pred->nflags != 0 && (pred->nflags & flags) != 0)
@@ -0,0 +1,248 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "seahorse-search-index.h"
+
+#include <gcr/gcr.h>
+
+#include <string.h>
+
+static const gchar *indexed_properties[] = {
+	"label",
+	"description",
+	"email",
+	"identifier",
+	"fingerprint",
+	NULL
+};
+
+typedef struct {
+	gchar *text;
+	GPtrArray *children;
+} IndexEntry;
+
+/* GObject -> IndexEntry, entries live as long as their object */
+static GHashTable *search_index = NULL;
+
+static void
+index_entry_free (gpointer data)
+{
+	IndexEntry *entry = data;
+	g_free (entry->text);
+	if (entry->children)
+		g_ptr_array_unref (entry->children);
+	g_slice_free (IndexEntry, entry);
+}
+
+static void
+on_object_notify (GObject *object,
+                  GParamSpec *pspec,
+                  gpointer user_data)
+{
+	IndexEntry *entry = user_data;
+	g_free (entry->text);
+	entry->text = NULL;
+}
+
+static void
+on_collection_changed (GcrCollection *collection,
+                       GObject *object,
+                       gpointer user_data)
+{
+	IndexEntry *entry = user_data;
+	if (entry->children)
+		g_ptr_array_unref (entry->children);
+	entry->children = NULL;
+}
+
+static void
+on_object_gone (gpointer data,
+                GObject *where_the_object_was)
+{
+	g_hash_table_remove (search_index, where_the_object_was);
+}
+
+static IndexEntry *
+index_entry_lookup (GObject *object)
+{
+	IndexEntry *entry;
+
+	if (search_index == NULL)
+		search_index = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+		                                      NULL, index_entry_free);
+
+	entry = g_hash_table_lookup (search_index, object);
+	if (entry != NULL)
+		return entry;
+
+	entry = g_slice_new0 (IndexEntry);
+	g_hash_table_insert (search_index, object, entry);
+	g_object_weak_ref (object, on_object_gone, NULL);
+
+	g_signal_connect (object, "notify", G_CALLBACK (on_object_notify), entry);
+	if (GCR_IS_COLLECTION (object)) {
+		g_signal_connect (object, "added", G_CALLBACK (on_collection_changed), entry);
+		g_signal_connect (object, "removed", G_CALLBACK (on_collection_changed), entry);
+	}
+
+	return entry;
+}
+
+static gchar *
+build_index_text (GObject *object)
+{
+	GObjectClass *klass = G_OBJECT_GET_CLASS (object);
+	GString *text;
+	GParamSpec *spec;
+	gchar *value;
+	gchar *folded;
+	guint i;
+
+	text = g_string_new ("");
+
+	for (i = 0; indexed_properties[i] != NULL; i++) {
+		spec = g_object_class_find_property (klass, indexed_properties[i]);
+		if (spec == NULL || spec->value_type != G_TYPE_STRING)
+			continue;
+
+		value = NULL;
+		g_object_get (object, indexed_properties[i], &value, NULL);
+		folded = seahorse_search_index_fold (value);
+		g_free (value);
+
+		/* Separate the fields so a match never spans two of them */
+		if (folded != NULL && folded[0]) {
+			if (text->len > 0)
+				g_string_append_c (text, '\n');
+			g_string_append (text, folded);
+		}
+		g_free (folded);
+	}
+
+	return g_string_free (text, FALSE);
+}
+
+static GPtrArray *
+build_index_children (GObject *object)
+{
+	GPtrArray *children;
+	GList *objects, *l;
+
+	children = g_ptr_array_new_with_free_func (g_object_unref);
+	objects = gcr_collection_get_objects (GCR_COLLECTION (object));
+	for (l = objects; l != NULL; l = g_list_next (l))
+		g_ptr_array_add (children, g_object_ref (l->data));
+	g_list_free (objects);
+
+	return children;
+}
+
+/**
+ * seahorse_search_index_fold:
+ * @text: (allow-none): text entered by the user
+ *
+ * Normalize and case fold text in the same way as the index does,
+ * so that it can be passed to seahorse_search_index_match().
+ *
+ * Returns: (transfer full): the folded text, or %NULL
+ */
+gchar *
+seahorse_search_index_fold (const gchar *text)
+{
+	gchar *normal;
+	gchar *folded;
+
+	if (text == NULL)
+		return NULL;
+
+	normal = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
+
+	/* Not valid UTF-8, still do something sensible */
+	if (normal == NULL)
+		return g_ascii_strdown (text, -1);
+
+	folded = g_utf8_casefold (normal, -1);
+	g_free (normal);
+	return folded;
+}
+
+/**
+ * seahorse_search_index_lookup:
+ * @object: the object
+ *
+ * Get the searchable text of an object, fields separated by new lines.
+ * Only the object itself is included, not any of its children.
+ *
+ * Returns: (transfer none): the folded text, valid until the object
+ *          next changes
+ */
+const gchar *
+seahorse_search_index_lookup (GObject *object)
+{
+	IndexEntry *entry;
+
+	g_return_val_if_fail (G_IS_OBJECT (object), NULL);
+
+	entry = index_entry_lookup (object);
+	if (entry->text == NULL)
+		entry->text = build_index_text (object);
+	return entry->text;
+}
+
+/**
+ * seahorse_search_index_match:
+ * @object: the object
+ * @folded: (allow-none): text from seahorse_search_index_fold()
+ *
+ * Check whether the object, or when it is a collection, one of its
+ * children contains the text. Once the object has been indexed this
+ * does not allocate memory.
+ *
+ * Returns: whether the object matches, empty text always matches
+ */
+gboolean
+seahorse_search_index_match (GObject *object,
+                             const gchar *folded)
+{
+	IndexEntry *entry;
+	guint i;
+
+	g_return_val_if_fail (G_IS_OBJECT (object), FALSE);
+
+	if (folded == NULL || !folded[0])
+		return TRUE;
+
+	if (strstr (seahorse_search_index_lookup (object), folded))
+		return TRUE;
+
+	if (!GCR_IS_COLLECTION (object))
+		return FALSE;
+
+	entry = index_entry_lookup (object);
+	if (entry->children == NULL)
+		entry->children = build_index_children (object);
+
+	for (i = 0; i < entry->children->len; i++) {
+		if (seahorse_search_index_match (entry->children->pdata[i], folded))
+			return TRUE;
+	}
+
+	return FALSE;
+}
@@ -0,0 +1,41 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * A shared index of the searchable text of objects.
+ *
+ * - Holds the label, description, email, identifier and fingerprint of
+ *   each object, normalized and case folded, in a single string.
+ * - Is filled in lazily the first time an object is matched, and thrown
+ *   away when the object emits a "notify" signal or goes away.
+ * - Only to be used from the main thread.
+ */
+
+#ifndef __SEAHORSE_SEARCH_INDEX_H__
+#define __SEAHORSE_SEARCH_INDEX_H__
+
+#include <glib-object.h>
+
+gchar *            seahorse_search_index_fold       (const gchar *text);
+
+const gchar *      seahorse_search_index_lookup     (GObject *object);
+
+gboolean           seahorse_search_index_match      (GObject *object,
+                                                     const gchar *folded);
+
+#endif /* __SEAHORSE_SEARCH_INDEX_H__ */
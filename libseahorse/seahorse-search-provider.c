@@ -24,7 +24,9 @@
 #include "seahorse-application.h"
 #include "seahorse-collection.h"
 #include "seahorse-predicate.h"
+#include "seahorse-search-index.h"
 #include "seahorse-search-provider.h"
+#include "seahorse-trigram-index.h"
 #include "seahorse-widget.h"
 #include "seahorse-shell-search-provider-generated.h"
 
@@ -48,7 +50,10 @@ struct _SeahorseSearchProvider {
 
 	SeahorsePredicate base_predicate;
 	GcrCollection *collection;
-	GHashTable *handles;
+	SeahorseTrigramIndex *index;
+	GArray *handles;
+	GArray *free_handles;
+	GHashTable *handle_for_object;
 	GList *queued_requests;
 	int n_loading;
 };
@@ -67,38 +72,17 @@ typedef struct {
 	char                 **terms;
 } QueuedRequest;
 
-/* Search through row for text */
-static gboolean
-object_contains_filtered_text (GObject     *object,
-			       const gchar *text)
-{
-	gchar* name = NULL;
-	gchar* description = NULL;
-	gchar* lower;
-	gboolean ret = FALSE;
-
-	g_object_get (object, "label", &name, NULL);
-	if (name != NULL) {
-		lower = g_utf8_strdown (name, -1);
-		if (strstr (lower, text))
-			ret = TRUE;
-		g_free (lower);
-		g_free (name);
-	}
-
-	if (!ret && g_object_class_find_property (G_OBJECT_GET_CLASS (object), "description")) {
-		g_object_get (object, "description", &description, NULL);
-		if (description != NULL) {
-			lower = g_utf8_strdown (description, -1);
-			if (strstr (lower, text))
-				ret = TRUE;
-			g_free (lower);
-			g_free (description);
-		}
-	}
-
-	return ret;
-}
+/*
+ * Every object in the collection gets a slot, and the result identifiers
+ * handed to the shell are "slot:generation". The generation is bumped
+ * whenever a slot is reused, so stale identifiers are never resolved.
+ */
+typedef struct {
+	GObject  *object;
+	guint     generation;
+	char     *id;
+	GVariant *meta;
+} ResultHandle;
 
 static gboolean
 object_matches_search (GObject     *object,
@@ -108,13 +92,41 @@ object_matches_search (GObject     *object,
 	int i;
 
 	for (i = 0; terms[i]; i++) {
-		if (!object_contains_filtered_text (object, terms[i]))
+		if (!seahorse_search_index_match (object, terms[i]))
 			return FALSE;
 	}
 
 	return TRUE;
 }
 
+static char **
+fold_search_terms (const char * const *terms)
+{
+	char **folded;
+	int i;
+
+	folded = g_new0 (char *, g_strv_length ((char **) terms) + 1);
+	for (i = 0; terms[i]; i++)
+		folded[i] = seahorse_search_index_fold (terms[i]);
+
+	return folded;
+}
+
+/* The term that narrows the candidates down the most */
+static const char *
+longest_search_term (char **terms)
+{
+	const char *longest = NULL;
+	int i;
+
+	for (i = 0; terms[i]; i++) {
+		if (!longest || strlen (terms[i]) > strlen (longest))
+			longest = terms[i];
+	}
+
+	return longest;
+}
+
 static void
 init_predicate (SeahorsePredicate  *predicate,
                 char              **terms)
@@ -126,13 +138,181 @@ init_predicate (SeahorsePredicate  *predicate,
 }
 
 static void
-on_object_gone (gpointer data,
-		GObject *where_the_object_was)
+on_handle_object_notify (GObject    *object,
+			 GParamSpec *pspec,
+			 gpointer    user_data)
 {
-	GHashTable *handles = data;
-	gchar *str = g_strdup_printf ("%p", (gpointer)where_the_object_was);
-	g_hash_table_remove (handles, str);
-	g_free (str);
+	SeahorseSearchProvider *self = SEAHORSE_SEARCH_PROVIDER (user_data);
+	ResultHandle *handle;
+	gpointer slot;
+
+	slot = g_hash_table_lookup (self->handle_for_object, object);
+	if (slot == NULL)
+		return;
+
+	handle = &g_array_index (self->handles, ResultHandle, GPOINTER_TO_UINT (slot) - 1);
+	if (handle->meta)
+		g_variant_unref (handle->meta);
+	handle->meta = NULL;
+}
+
+static void
+register_handle (SeahorseSearchProvider *self,
+		 GObject                *object)
+{
+	ResultHandle *handle;
+	guint slot;
+
+	if (g_hash_table_contains (self->handle_for_object, object))
+		return;
+
+	if (self->free_handles->len > 0) {
+		slot = g_array_index (self->free_handles, guint, self->free_handles->len - 1);
+		g_array_set_size (self->free_handles, self->free_handles->len - 1);
+	} else {
+		slot = self->handles->len;
+		g_array_set_size (self->handles, slot + 1);
+	}
+
+	handle = &g_array_index (self->handles, ResultHandle, slot);
+	handle->object = object;
+	handle->id = g_strdup_printf ("%u:%u", slot, handle->generation);
+
+	/* Slots are stored off by one, so that zero means none */
+	g_hash_table_insert (self->handle_for_object, object, GUINT_TO_POINTER (slot + 1));
+	g_signal_connect (object, "notify", G_CALLBACK (on_handle_object_notify), self);
+}
+
+static void
+unregister_handle (SeahorseSearchProvider *self,
+		   GObject                *object)
+{
+	ResultHandle *handle;
+	gpointer slot;
+	guint index;
+
+	slot = g_hash_table_lookup (self->handle_for_object, object);
+	if (slot == NULL)
+		return;
+
+	index = GPOINTER_TO_UINT (slot) - 1;
+	handle = &g_array_index (self->handles, ResultHandle, index);
+
+	g_signal_handlers_disconnect_by_func (object, on_handle_object_notify, self);
+	g_hash_table_remove (self->handle_for_object, object);
+
+	if (handle->meta)
+		g_variant_unref (handle->meta);
+	g_free (handle->id);
+	handle->meta = NULL;
+	handle->id = NULL;
+	handle->object = NULL;
+	handle->generation++;
+
+	g_array_append_val (self->free_handles, index);
+}
+
+static ResultHandle *
+lookup_handle (SeahorseSearchProvider *self,
+	       const char             *id)
+{
+	ResultHandle *handle;
+	guint64 slot, generation;
+	char *end;
+
+	slot = g_ascii_strtoull (id, &end, 10);
+	if (end == id || *end != ':')
+		return NULL;
+	id = end + 1;
+	generation = g_ascii_strtoull (id, &end, 10);
+	if (end == id || *end != '\0')
+		return NULL;
+
+	if (slot >= self->handles->len)
+		return NULL;
+
+	handle = &g_array_index (self->handles, ResultHandle, slot);
+	if (handle->object == NULL || handle->generation != generation)
+		return NULL;
+
+	return handle;
+}
+
+static ResultHandle *
+handle_for_object (SeahorseSearchProvider *self,
+		   GObject                *object)
+{
+	gpointer slot;
+
+	slot = g_hash_table_lookup (self->handle_for_object, object);
+	if (slot == NULL)
+		return NULL;
+
+	return &g_array_index (self->handles, ResultHandle, GPOINTER_TO_UINT (slot) - 1);
+}
+
+/* Serialized once, and again only after the object changes */
+static GVariant *
+handle_get_meta (ResultHandle *handle)
+{
+	GVariantBuilder builder;
+	char *name, *description, *escaped_description;
+	GVariant *icon_variant;
+	GIcon *icon;
+
+	if (handle->meta)
+		return handle->meta;
+
+	g_object_get (handle->object,
+	              "label", &name,
+	              "icon", &icon,
+	              "description", &description,
+	              NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}",
+	                       "id", g_variant_new_string (handle->id));
+	if (name) {
+		g_variant_builder_add (&builder, "{sv}",
+		                       "name", g_variant_new_string (name));
+		g_free (name);
+	}
+	if (icon) {
+		icon_variant = g_icon_serialize (icon);
+		if (icon_variant) {
+			g_variant_builder_add (&builder, "{sv}",
+					       "icon", icon_variant);
+			g_variant_unref (icon_variant);
+		}
+		g_object_unref (icon);
+	}
+	if (description) {
+		escaped_description = description ? g_markup_escape_text (description, -1) : NULL;
+		g_variant_builder_add (&builder, "{sv}",
+		                       "description",
+		                       escaped_description ? g_variant_new_string (description) : NULL);
+		g_free (escaped_description);
+		g_free (description);
+	}
+
+	handle->meta = g_variant_ref_sink (g_variant_builder_end (&builder));
+	return handle->meta;
+}
+
+static void
+on_collection_added (GcrCollection *collection,
+		     GObject       *object,
+		     gpointer       user_data)
+{
+	register_handle (SEAHORSE_SEARCH_PROVIDER (user_data), object);
+}
+
+static void
+on_collection_removed (GcrCollection *collection,
+		       GObject       *object,
+		       gpointer       user_data)
+{
+	unregister_handle (SEAHORSE_SEARCH_PROVIDER (user_data), object);
 }
 
 /* We called before loading, we queue GetInitialResultSet, but
@@ -198,32 +378,36 @@ handle_get_initial_result_set (SeahorseShellSearchProvider2 *skeleton,
 	SeahorseSearchProvider *self = SEAHORSE_SEARCH_PROVIDER (skeleton);
 	SeahorsePredicate   predicate;
 	GPtrArray *array;
-	GList *objects, *l;
+	GHashTable *candidates;
+	GHashTableIter iter;
+	ResultHandle *handle;
+	GObject *object;
 	char **results;
+	char **folded;
 
 	hold_app ();
 
 	if (queue_request_if_not_loaded (self, invocation, terms))
 		return TRUE;
 
-	init_predicate (&predicate, (char **) terms);
+	folded = fold_search_terms (terms);
+	init_predicate (&predicate, folded);
 
 	array = g_ptr_array_new ();
-	objects = gcr_collection_get_objects (self->collection);
-
-	for (l = objects; l; l = l->next) {
-		if (seahorse_predicate_match (&predicate, l->data)) {
-			char *str = g_strdup_printf("%p", l->data);
+	candidates = seahorse_trigram_index_candidates (self->index,
+	                                                longest_search_term (folded));
 
-			if (!g_hash_table_contains (self->handles, str)) {
-				g_hash_table_insert (self->handles, g_strdup (str), l->data);
-				g_object_weak_ref (l->data, on_object_gone, self->handles);
-			}
-			g_ptr_array_add (array, str);
+	g_hash_table_iter_init (&iter, candidates);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL)) {
+		if (seahorse_predicate_match (&predicate, object)) {
+			handle = handle_for_object (self, object);
+			if (handle != NULL)
+				g_ptr_array_add (array, handle->id);
 		}
 	}
 
-	g_list_free (objects);
+	g_hash_table_destroy (candidates);
+	g_strfreev (folded);
 	g_ptr_array_add (array, NULL);
 	results = (char **) g_ptr_array_free (array, FALSE);
 
@@ -231,7 +415,8 @@ handle_get_initial_result_set (SeahorseShellSearchProvider2 *skeleton,
 	                                                                 invocation,
 	                                                                 (const char* const*) results);
 
-	g_strfreev (results);
+	/* g_free, not g_strfreev, because the handles own the result strings */
+	g_free (results);
 	release_app ();
 	return TRUE;
 }
@@ -247,29 +432,32 @@ handle_get_subsearch_result_set (SeahorseShellSearchProvider2 *skeleton,
 	GPtrArray *array;
 	int i;
 	char **results;
+	char **folded;
 
        	if (error_request_if_not_loaded (self, invocation))
 		return TRUE;
 
 	hold_app ();
-	init_predicate (&predicate, (char **) terms);
+	folded = fold_search_terms (terms);
+	init_predicate (&predicate, folded);
 
 	array = g_ptr_array_new ();
 
 	for (i = 0; previous_results[i]; i++) {
-		GObject *object;
+		ResultHandle *handle;
 
-		object = g_hash_table_lookup (self->handles, previous_results[i]);
-		if (!object || !gcr_collection_contains (self->collection, object)) {
+		handle = lookup_handle (self, previous_results[i]);
+		if (!handle) {
 			/* Bogus value */
 			continue;
 		}
 
-		if (seahorse_predicate_match (&predicate, object)) {
+		if (seahorse_predicate_match (&predicate, handle->object)) {
 			g_ptr_array_add (array, (char*) previous_results[i]);
 		}
 	}
 
+	g_strfreev (folded);
 	g_ptr_array_add (array, NULL);
 	results = (char **) g_ptr_array_free (array, FALSE);
 
@@ -291,9 +479,7 @@ handle_get_result_metas (SeahorseShellSearchProvider2 *skeleton,
 	SeahorseSearchProvider *self = SEAHORSE_SEARCH_PROVIDER (skeleton);
 	int i;
 	GVariantBuilder builder;
-	char *name, *description, *escaped_description;
-	GVariant *icon_variant;
-	GIcon *icon;
+	ResultHandle *handle;
 
 	if (error_request_if_not_loaded (self, invocation))
 		return TRUE;
@@ -302,47 +488,13 @@ handle_get_result_metas (SeahorseShellSearchProvider2 *skeleton,
 	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
 
 	for (i = 0; results[i]; i++) {
-		GObject *object;
-
-		object = g_hash_table_lookup (self->handles, results[i]);
-		if (!object || !gcr_collection_contains (self->collection, object)) {
+		handle = lookup_handle (self, results[i]);
+		if (!handle) {
 			/* Bogus value */
 			continue;
 		}
 
-		g_object_get (object,
-		              "label", &name,
-		              "icon", &icon,
-		              "description", &description,
-		              NULL);
-
-		g_variant_builder_open (&builder, G_VARIANT_TYPE ("a{sv}"));
-		g_variant_builder_add (&builder, "{sv}",
-		                       "id", g_variant_new_string (results[i]));
-		if (name) {
-			g_variant_builder_add (&builder, "{sv}",
-			                       "name", g_variant_new_string (name));
-			g_free (name);
-		}
-		if (icon) {
-			icon_variant = g_icon_serialize (icon);
-			if (icon_variant) {
-				g_variant_builder_add (&builder, "{sv}",
-						       "icon", icon_variant);
-				g_variant_unref (icon_variant);
-			}
-			g_object_unref (icon);
-		}
-		if (description) {
-			escaped_description = description ? g_markup_escape_text (description, -1) : NULL;
-			g_variant_builder_add (&builder, "{sv}",
-			                       "description",
-			                       escaped_description ? g_variant_new_string (description) : NULL);
-			g_free (escaped_description);
-			g_free (description);
-		}
-
-		g_variant_builder_close (&builder);
+		g_variant_builder_add_value (&builder, handle_get_meta (handle));
 	}
 
 	seahorse_shell_search_provider2_complete_get_result_metas (skeleton,
@@ -360,6 +512,7 @@ handle_activate_result (SeahorseShellSearchProvider2 *skeleton,
                         guint                         timestamp)
 {
 	SeahorseSearchProvider *self = SEAHORSE_SEARCH_PROVIDER (skeleton);
+	ResultHandle *handle;
 	GObject *object;
 	SeahorseKeyManager *key_manager;
 
@@ -367,15 +520,14 @@ handle_activate_result (SeahorseShellSearchProvider2 *skeleton,
 		return TRUE;
 
 	hold_app ();
-	sscanf (identifier, "%p", &object);
 
-	object = g_hash_table_lookup (self->handles, identifier);
-	if (!object || !gcr_collection_contains (self->collection, object) ||
-	    !SEAHORSE_IS_VIEWABLE (object)) {
+	handle = lookup_handle (self, identifier);
+	if (!handle || !SEAHORSE_IS_VIEWABLE (handle->object)) {
 		/* Bogus value */
 		return TRUE;
 	}
 
+	object = handle->object;
 	key_manager = seahorse_key_manager_show (timestamp);
 	seahorse_viewable_view (object, GTK_WINDOW (key_manager));
 
@@ -517,8 +669,13 @@ seahorse_search_provider_init (SeahorseSearchProvider *self)
 	filtered = seahorse_collection_new_for_predicate (base,
 	                                                  &self->base_predicate, NULL);
 	self->collection = GCR_COLLECTION (filtered);
+	self->index = seahorse_trigram_index_new (self->collection);
 
-	self->handles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	self->handles = g_array_new (FALSE, TRUE, sizeof (ResultHandle));
+	self->free_handles = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->handle_for_object = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_signal_connect (self->collection, "added", G_CALLBACK (on_collection_added), self);
+	g_signal_connect (self->collection, "removed", G_CALLBACK (on_collection_removed), self);
 }
 
 gboolean
@@ -551,9 +708,22 @@ static void
 seahorse_search_provider_dispose (GObject *object)
 {
 	SeahorseSearchProvider *self;
+	GList *objects, *l;
 
 	self = SEAHORSE_SEARCH_PROVIDER (object);
 
+	seahorse_trigram_index_free (self->index);
+	self->index = NULL;
+
+	if (self->collection) {
+		g_signal_handlers_disconnect_by_func (self->collection, on_collection_added, self);
+		g_signal_handlers_disconnect_by_func (self->collection, on_collection_removed, self);
+		objects = g_hash_table_get_keys (self->handle_for_object);
+		for (l = objects; l != NULL; l = g_list_next (l))
+			unregister_handle (self, l->data);
+		g_list_free (objects);
+	}
+
 	g_clear_object (&self->collection);
 
 	G_OBJECT_CLASS (seahorse_search_provider_parent_class)->dispose (object);
@@ -563,13 +733,10 @@ static void
 seahorse_search_provider_finalize (GObject *object)
 {
 	SeahorseSearchProvider *self = SEAHORSE_SEARCH_PROVIDER (object);
-	GHashTableIter iter;
-	gpointer value;
 
-	g_hash_table_iter_init (&iter, self->handles);
-	while (g_hash_table_iter_next (&iter, NULL, &value))
-		g_object_weak_unref (value, on_object_gone, self->handles);
-	g_hash_table_destroy (self->handles);
+	g_array_free (self->handles, TRUE);
+	g_array_free (self->free_handles, TRUE);
+	g_hash_table_destroy (self->handle_for_object);
 
 	G_OBJECT_CLASS (seahorse_search_provider_parent_class)->finalize (object);
 }
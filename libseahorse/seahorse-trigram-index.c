@@ -0,0 +1,407 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "seahorse-search-index.h"
+#include "seahorse-trigram-index.h"
+
+#include <string.h>
+
+#define TRIGRAM(s) \
+	(GUINT_TO_POINTER (((guint)(guchar)(s)[0] << 16) | \
+	                   ((guint)(guchar)(s)[1] << 8) | \
+	                   (guint)(guchar)(s)[2]))
+
+struct _SeahorseTrigramIndex {
+	GcrCollection *collection;
+
+	/* GObject -> GArray of trigrams the object is listed under */
+	GHashTable *objects;
+
+	/* Trigram -> GHashTable set of objects */
+	GHashTable *postings;
+
+	/* Objects that changed since they were last indexed */
+	GHashTable *dirty;
+
+	/* Child GObject -> parent GObject, for children being watched */
+	GHashTable *children;
+};
+
+static void
+add_text_trigrams (GHashTable *trigrams,
+                   const gchar *text)
+{
+	gsize i, len;
+
+	len = text ? strlen (text) : 0;
+	for (i = 0; i + 3 <= len; i++)
+		g_hash_table_add (trigrams, TRIGRAM (text + i));
+}
+
+static void
+index_object (SeahorseTrigramIndex *self,
+              GObject *object)
+{
+	GHashTable *trigrams;
+	GHashTable *posting;
+	GHashTableIter iter;
+	GList *children, *l;
+	GArray *listed;
+	gpointer trigram;
+
+	trigrams = g_hash_table_new (g_direct_hash, g_direct_equal);
+	add_text_trigrams (trigrams, seahorse_search_index_lookup (object));
+
+	/* Children are matched along with their parent */
+	if (GCR_IS_COLLECTION (object)) {
+		children = gcr_collection_get_objects (GCR_COLLECTION (object));
+		for (l = children; l != NULL; l = g_list_next (l))
+			add_text_trigrams (trigrams, seahorse_search_index_lookup (l->data));
+		g_list_free (children);
+	}
+
+	listed = g_array_sized_new (FALSE, FALSE, sizeof (guint),
+	                            g_hash_table_size (trigrams));
+
+	g_hash_table_iter_init (&iter, trigrams);
+	while (g_hash_table_iter_next (&iter, &trigram, NULL)) {
+		posting = g_hash_table_lookup (self->postings, trigram);
+		if (posting == NULL) {
+			posting = g_hash_table_new (g_direct_hash, g_direct_equal);
+			g_hash_table_insert (self->postings, trigram, posting);
+		}
+		g_hash_table_add (posting, object);
+		g_array_append_val (listed, trigram);
+	}
+
+	g_hash_table_destroy (trigrams);
+	g_hash_table_replace (self->objects, object, listed);
+}
+
+static void
+unindex_object (SeahorseTrigramIndex *self,
+                GObject *object)
+{
+	GHashTable *posting;
+	GArray *listed;
+	gpointer trigram;
+	guint i;
+
+	listed = g_hash_table_lookup (self->objects, object);
+	if (listed == NULL)
+		return;
+
+	for (i = 0; i < listed->len; i++) {
+		trigram = GUINT_TO_POINTER (g_array_index (listed, guint, i));
+		posting = g_hash_table_lookup (self->postings, trigram);
+		if (posting == NULL)
+			continue;
+		g_hash_table_remove (posting, object);
+		if (g_hash_table_size (posting) == 0)
+			g_hash_table_remove (self->postings, trigram);
+	}
+
+	g_hash_table_remove (self->objects, object);
+}
+
+static void
+on_object_changed (GObject *object,
+                   GParamSpec *pspec,
+                   gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+	g_hash_table_add (self->dirty, object);
+}
+
+/* A child's text is indexed under its parent, so reindex the parent */
+static void
+on_child_changed (GObject *child,
+                  GParamSpec *pspec,
+                  gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+	GObject *parent;
+
+	parent = g_hash_table_lookup (self->children, child);
+	if (parent != NULL)
+		g_hash_table_add (self->dirty, parent);
+}
+
+static void
+watch_child (SeahorseTrigramIndex *self,
+             GObject *parent,
+             GObject *child)
+{
+	if (g_hash_table_contains (self->children, child))
+		return;
+
+	g_hash_table_insert (self->children, child, parent);
+	g_signal_connect (child, "notify", G_CALLBACK (on_child_changed), self);
+}
+
+static void
+unwatch_child (SeahorseTrigramIndex *self,
+               GObject *child)
+{
+	if (g_hash_table_remove (self->children, child))
+		g_signal_handlers_disconnect_by_func (child, on_child_changed, self);
+}
+
+/* Stop watching the children of @parent, or of every object when %NULL */
+static void
+unwatch_children (SeahorseTrigramIndex *self,
+                  GObject *parent)
+{
+	GHashTableIter iter;
+	GObject *child;
+	GObject *owner;
+
+	g_hash_table_iter_init (&iter, self->children);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&child, (gpointer *)&owner)) {
+		if (parent == NULL || owner == parent) {
+			g_signal_handlers_disconnect_by_func (child, on_child_changed, self);
+			g_hash_table_iter_remove (&iter);
+		}
+	}
+}
+
+static void
+on_child_added (GcrCollection *parent,
+                GObject *child,
+                gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+
+	watch_child (self, G_OBJECT (parent), child);
+	g_hash_table_add (self->dirty, parent);
+}
+
+static void
+on_child_removed (GcrCollection *parent,
+                  GObject *child,
+                  gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+
+	unwatch_child (self, child);
+	g_hash_table_add (self->dirty, parent);
+}
+
+static void
+on_collection_added (GcrCollection *collection,
+                     GObject *object,
+                     gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+	GList *children, *l;
+
+	if (g_hash_table_contains (self->objects, object))
+		return;
+
+	g_signal_connect (object, "notify", G_CALLBACK (on_object_changed), self);
+	if (GCR_IS_COLLECTION (object)) {
+		g_signal_connect (object, "added", G_CALLBACK (on_child_added), self);
+		g_signal_connect (object, "removed", G_CALLBACK (on_child_removed), self);
+		children = gcr_collection_get_objects (GCR_COLLECTION (object));
+		for (l = children; l != NULL; l = g_list_next (l))
+			watch_child (self, object, l->data);
+		g_list_free (children);
+	}
+
+	/* Indexed on the next search, objects often change right after being added */
+	g_hash_table_replace (self->objects, object,
+	                      g_array_new (FALSE, FALSE, sizeof (guint)));
+	g_hash_table_add (self->dirty, object);
+}
+
+static void
+on_collection_removed (GcrCollection *collection,
+                       GObject *object,
+                       gpointer user_data)
+{
+	SeahorseTrigramIndex *self = user_data;
+
+	if (!g_hash_table_contains (self->objects, object))
+		return;
+
+	g_signal_handlers_disconnect_by_func (object, on_object_changed, self);
+	g_signal_handlers_disconnect_by_func (object, on_child_added, self);
+	g_signal_handlers_disconnect_by_func (object, on_child_removed, self);
+	unwatch_children (self, object);
+	g_hash_table_remove (self->dirty, object);
+	unindex_object (self, object);
+}
+
+static void
+flush_dirty (SeahorseTrigramIndex *self)
+{
+	GHashTableIter iter;
+	GObject *object;
+
+	g_hash_table_iter_init (&iter, self->dirty);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL)) {
+		unindex_object (self, object);
+		index_object (self, object);
+	}
+
+	g_hash_table_remove_all (self->dirty);
+}
+
+/**
+ * seahorse_trigram_index_new:
+ * @collection: the objects to index
+ *
+ * Create an index for the objects in a collection. It is kept up to
+ * date as the collection and its objects change.
+ *
+ * Returns: (transfer full): the index, free with seahorse_trigram_index_free()
+ */
+SeahorseTrigramIndex *
+seahorse_trigram_index_new (GcrCollection *collection)
+{
+	SeahorseTrigramIndex *self;
+	GList *objects, *l;
+
+	g_return_val_if_fail (GCR_IS_COLLECTION (collection), NULL);
+
+	self = g_slice_new0 (SeahorseTrigramIndex);
+	self->collection = g_object_ref (collection);
+	self->objects = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+	                                       NULL, (GDestroyNotify)g_array_unref);
+	self->postings = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+	                                        NULL, (GDestroyNotify)g_hash_table_destroy);
+	self->dirty = g_hash_table_new (g_direct_hash, g_direct_equal);
+	self->children = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	g_signal_connect (collection, "added", G_CALLBACK (on_collection_added), self);
+	g_signal_connect (collection, "removed", G_CALLBACK (on_collection_removed), self);
+
+	objects = gcr_collection_get_objects (collection);
+	for (l = objects; l != NULL; l = g_list_next (l))
+		on_collection_added (collection, l->data, self);
+	g_list_free (objects);
+
+	return self;
+}
+
+/**
+ * seahorse_trigram_index_candidates:
+ * @index: the index
+ * @folded: text from seahorse_search_index_fold()
+ *
+ * Find the objects whose text contains every trigram of the search text.
+ * Text shorter than a trigram cannot narrow anything down, so then all
+ * the objects are returned.
+ *
+ * Returns: (transfer container): a set of candidate objects
+ */
+GHashTable *
+seahorse_trigram_index_candidates (SeahorseTrigramIndex *index,
+                                   const gchar *folded)
+{
+	GHashTable *candidates;
+	GHashTable *smallest = NULL;
+	GHashTable *posting;
+	GHashTableIter iter;
+	GPtrArray *others;
+	gpointer object;
+	gsize i, len;
+	guint j;
+
+	g_return_val_if_fail (index != NULL, NULL);
+
+	flush_dirty (index);
+	candidates = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	len = folded ? strlen (folded) : 0;
+	if (len < 3) {
+		g_hash_table_iter_init (&iter, index->objects);
+		while (g_hash_table_iter_next (&iter, &object, NULL))
+			g_hash_table_add (candidates, object);
+		return candidates;
+	}
+
+	others = g_ptr_array_new ();
+	for (i = 0; i + 3 <= len; i++) {
+		posting = g_hash_table_lookup (index->postings, TRIGRAM (folded + i));
+
+		/* A trigram nothing has, so nothing matches */
+		if (posting == NULL) {
+			g_ptr_array_free (others, TRUE);
+			return candidates;
+		}
+
+		if (smallest == NULL) {
+			smallest = posting;
+		} else if (g_hash_table_size (posting) < g_hash_table_size (smallest)) {
+			g_ptr_array_add (others, smallest);
+			smallest = posting;
+		} else {
+			g_ptr_array_add (others, posting);
+		}
+	}
+
+	g_hash_table_iter_init (&iter, smallest);
+	while (g_hash_table_iter_next (&iter, &object, NULL)) {
+		for (j = 0; j < others->len; j++) {
+			if (!g_hash_table_contains (others->pdata[j], object))
+				break;
+		}
+		if (j == others->len)
+			g_hash_table_add (candidates, object);
+	}
+
+	g_ptr_array_free (others, TRUE);
+	return candidates;
+}
+
+/**
+ * seahorse_trigram_index_free:
+ * @index: the index
+ *
+ * Stop following the collection and free the index.
+ */
+void
+seahorse_trigram_index_free (SeahorseTrigramIndex *index)
+{
+	GHashTableIter iter;
+	GObject *object;
+
+	if (index == NULL)
+		return;
+
+	g_signal_handlers_disconnect_by_func (index->collection, on_collection_added, index);
+	g_signal_handlers_disconnect_by_func (index->collection, on_collection_removed, index);
+
+	g_hash_table_iter_init (&iter, index->objects);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&object, NULL)) {
+		g_signal_handlers_disconnect_by_func (object, on_object_changed, index);
+		g_signal_handlers_disconnect_by_func (object, on_child_added, index);
+		g_signal_handlers_disconnect_by_func (object, on_child_removed, index);
+	}
+	unwatch_children (index, NULL);
+
+	g_hash_table_destroy (index->children);
+	g_hash_table_destroy (index->dirty);
+	g_hash_table_destroy (index->postings);
+	g_hash_table_destroy (index->objects);
+	g_object_unref (index->collection);
+	g_slice_free (SeahorseTrigramIndex, index);
+}
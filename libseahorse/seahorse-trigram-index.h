@@ -0,0 +1,43 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * An inverted index from trigrams of searchable text to objects.
+ *
+ * - Covers the objects of one collection, and follows its "added" and
+ *   "removed" signals.
+ * - Uses the text from the search index, including that of children.
+ * - Objects that emit "notify" are indexed again on the next search.
+ * - Candidates still need to be checked with seahorse_search_index_match().
+ */
+
+#ifndef __SEAHORSE_TRIGRAM_INDEX_H__
+#define __SEAHORSE_TRIGRAM_INDEX_H__
+
+#include <gcr/gcr.h>
+
+typedef struct _SeahorseTrigramIndex SeahorseTrigramIndex;
+
+SeahorseTrigramIndex *  seahorse_trigram_index_new          (GcrCollection *collection);
+
+GHashTable *            seahorse_trigram_index_candidates   (SeahorseTrigramIndex *index,
+                                                             const gchar *folded);
+
+void                    seahorse_trigram_index_free         (SeahorseTrigramIndex *index);
+
+#endif /* __SEAHORSE_TRIGRAM_INDEX_H__ */
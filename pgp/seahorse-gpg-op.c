@@ -59,6 +59,10 @@ execute_gpg_command (gpgme_ctx_t ctx, const gchar *args, gchar **std_out,
     return gerr;
 }
 
+/*
+ * Exports all the secret keys matching @patterns with a single gpg. Only
+ * used when gpgme is too old to export secret keys itself.
+ */
 gpgme_error_t
 seahorse_gpg_op_export_secret (gpgme_ctx_t ctx,
                                const gchar **patterns,
@@ -66,51 +70,39 @@ seahorse_gpg_op_export_secret (gpgme_ctx_t ctx,
 {
 	gchar *output = NULL;
 	gpgme_error_t gerr;
-	gchar *args;
-	gsize i;
+	GString *args;
+	gchar *quoted;
+	gsize i, len;
+	gssize written;
 
 	g_return_val_if_fail (patterns != NULL, GPG_E (GPG_ERR_INV_VALUE));
 
-	for (i = 0; patterns[i] != NULL; i++) {
-		args = g_strdup_printf ("--armor --export-secret-key '%s'", patterns[i]);
-		gerr = execute_gpg_command (ctx, args, &output, NULL);
-		g_free (args);
-
-		if (!GPG_IS_OK (gerr))
-			return gerr;
+	if (patterns[0] == NULL)
+		return GPG_OK;
 
-		if (gpgme_data_write (keydata, output, strlen (output)) == -1)
-			return GPG_E (GPG_ERR_GENERAL);
-
-		g_free (output);
+	args = g_string_new ("--armor --export-secret-key");
+	for (i = 0; patterns[i] != NULL; i++) {
+		quoted = g_shell_quote (patterns[i]);
+		g_string_append_c (args, ' ');
+		g_string_append (args, quoted);
+		g_free (quoted);
 	}
 
-	return GPG_OK;
-}
+	gerr = execute_gpg_command (ctx, args->str, &output, NULL);
+	g_string_free (args, TRUE);
 
-gpgme_error_t 
-seahorse_gpg_op_num_uids (gpgme_ctx_t ctx, const char *pattern, guint *number)
-{
-	 gchar *output = NULL;
-    gpgme_error_t err;
-    gchar *args;
-    gchar *found = NULL;
-    
-    g_return_val_if_fail (pattern != NULL, GPG_E (GPG_ERR_INV_VALUE));
-    args = g_strdup_printf ("--list-keys '%s'", pattern);
-    
-    err = execute_gpg_command (ctx, args, &output, NULL);
-    g_free (args);
-    
-    if (!GPG_IS_OK (err))
-        return err;
-    
-    found = output;
-	while ((found = strstr(found, "uid")) != NULL) {
-		*number = *number + 1;
-		found += 3;
+	if (!GPG_IS_OK (gerr))
+		return gerr;
+
+	len = strlen (output);
+	for (i = 0; i < len; i += written) {
+		written = gpgme_data_write (keydata, output + i, len - i);
+		if (written <= 0) {
+			gerr = GPG_E (GPG_ERR_GENERAL);
+			break;
+		}
 	}
 
-    g_free (output);
-    return GPG_OK;
+	g_free (output);
+	return gerr;
 }
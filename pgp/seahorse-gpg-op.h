@@ -28,8 +28,4 @@ gpgme_error_t seahorse_gpg_op_export_secret  (gpgme_ctx_t ctx,
                                               const gchar **patterns,
                                               gpgme_data_t keydata);
 
-gpgme_error_t seahorse_gpg_op_num_uids       (gpgme_ctx_t ctx, 
-                                              const char *pattern,
-                                              guint *number);
-
 #endif /* __SEAHORSE_GPG_OP_H__ */
@@ -98,6 +98,21 @@ on_gpgme_add_subkey_never_expires_toggled (GtkToggleButton *togglebutton,
                               !gtk_toggle_button_get_active (togglebutton));
 }
 
+static void
+on_add_subkey_complete (GObject *source,
+                        GAsyncResult *result,
+                        gpointer user_data)
+{
+	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_add_subkey_finish (SEAHORSE_GPGME_KEY (source), result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't add subkey"));
+
+	seahorse_widget_destroy (swidget);
+	g_object_unref (swidget);
+}
+
 G_MODULE_EXPORT void
 on_gpgme_add_subkey_ok_clicked (GtkButton *button,
                                 gpointer user_data)
@@ -108,7 +123,6 @@ on_gpgme_add_subkey_ok_clicked (GtkButton *button,
 	gint type;
 	guint length;
 	time_t expires;
-	gpgme_error_t err;
 	GtkWidget *widget;
 	GtkComboBox *combo;
 	GtkTreeModel *model;
@@ -151,16 +165,12 @@ on_gpgme_add_subkey_ok_clicked (GtkButton *button,
 			break;
 	}
 	
+	/* The dialog stays up, insensitive, until gpg is done */
 	widget = GTK_WIDGET (seahorse_widget_get_widget (swidget, swidget->name));
 	gtk_widget_set_sensitive (widget, FALSE);
-	err = seahorse_gpgme_key_op_add_subkey (SEAHORSE_GPGME_KEY (skwidget->object), 
-	                                        real_type, length, expires);
-	gtk_widget_set_sensitive (widget, TRUE);
-	
-	if (!GPG_IS_OK (err))
-		seahorse_gpgme_handle_error (err, _("Couldn't add subkey"));
-
-	seahorse_widget_destroy (swidget);
+	seahorse_gpgme_key_op_add_subkey_async (SEAHORSE_GPGME_KEY (skwidget->object),
+	                                        real_type, length, expires, NULL,
+	                                        on_add_subkey_complete, g_object_ref (swidget));
 }
 
 void
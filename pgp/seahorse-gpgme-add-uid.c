@@ -75,6 +75,25 @@ on_gpgme_add_uid_email_changed (GtkEditable *editable,
 	check_ok (swidget);
 }
 
+static void
+on_add_uid_complete (GObject *source,
+                     GAsyncResult *result,
+                     gpointer user_data)
+{
+	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
+	GError *error = NULL;
+
+	/* Leave the dialog up on failure, so the user can try again */
+	if (!seahorse_gpgme_key_op_add_uid_finish (SEAHORSE_GPGME_KEY (source), result, &error)) {
+		seahorse_util_handle_error (&error, swidget, _("Couldn't add user id"));
+		gtk_widget_set_sensitive (seahorse_widget_get_toplevel (swidget), TRUE);
+	} else {
+		seahorse_widget_destroy (swidget);
+	}
+
+	g_object_unref (swidget);
+}
+
 G_MODULE_EXPORT void
 on_gpgme_add_uid_ok_clicked (GtkButton *button,
                              gpointer user_data)
@@ -82,7 +101,6 @@ on_gpgme_add_uid_ok_clicked (GtkButton *button,
 	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
 	GObject *object;
 	const gchar *name, *email, *comment;
-	gpgme_error_t err;
 
 	object = SEAHORSE_OBJECT_WIDGET (swidget)->object;
 	
@@ -93,12 +111,10 @@ on_gpgme_add_uid_ok_clicked (GtkButton *button,
 	comment = gtk_entry_get_text (GTK_ENTRY (
 		seahorse_widget_get_widget (swidget, "comment")));
 	
-	err = seahorse_gpgme_key_op_add_uid (SEAHORSE_GPGME_KEY (object),
-	                                     name, email, comment);
-	if (!GPG_IS_OK (err))
-		seahorse_gpgme_handle_error (err, _("Couldn't add user id"));
-	else
-		seahorse_widget_destroy (swidget);
+	gtk_widget_set_sensitive (seahorse_widget_get_toplevel (swidget), FALSE);
+	seahorse_gpgme_key_op_add_uid_async (SEAHORSE_GPGME_KEY (object),
+	                                     name, email, comment, NULL,
+	                                     on_add_uid_complete, g_object_ref (swidget));
 }
 
 /**
@@ -0,0 +1,467 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "seahorse-gpgme-cache.h"
+
+#include "seahorse-gpg-options.h"
+#include "seahorse-pgp-subkey.h"
+#include "seahorse-pgp-uid.h"
+
+#include <glib/gstdio.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * The cache file is laid out as a header, followed by an array of fixed
+ * size records, followed by a table of nul terminated strings. Records
+ * refer to strings by their offset in the table. Offset zero is always
+ * the empty string. Everything is in host byte order, the cache is never
+ * shared between machines.
+ */
+
+#define CACHE_MAGIC      0x53484743 /* SHGC */
+#define CACHE_VERSION    2
+
+/* The files in the GnuPG home directory that the cache depends on */
+static const gchar *STAMP_FILES[] = {
+	"pubring.kbx",
+	"pubring.gpg",
+	"secring.gpg",
+	"trustdb.gpg",
+	"private-keys-v1.d",
+};
+
+#define N_STAMP_FILES G_N_ELEMENTS (STAMP_FILES)
+
+typedef struct {
+	guint64 device;
+	guint64 inode;
+	guint64 size;
+	guint64 mtime;
+	guint64 mtime_nsec;
+} CacheStamp;
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	CacheStamp stamps[N_STAMP_FILES];
+	guint32 homedir;
+	guint32 n_records;
+	guint32 n_strings;
+	guint32 reserved;
+} CacheHeader;
+
+typedef struct {
+	guint32 keyid;
+	guint32 fingerprint;
+	guint32 name;
+	guint32 email;
+	guint32 comment;
+	guint32 algo;
+	guint32 length;
+	guint32 usage;
+	guint32 flags;
+	guint32 validity;
+	guint32 trust;
+	guint32 reserved;
+	guint64 created;
+	guint64 expires;
+} CacheRecord;
+
+struct _SeahorseGpgmeCache {
+	GMappedFile *mapped;
+	const CacheHeader *header;
+	const CacheRecord *records;
+	const gchar *strings;
+};
+
+static gchar *
+cache_filename (void)
+{
+	return g_build_filename (g_get_user_cache_dir (), "seahorse", "gnupg-keys.cache", NULL);
+}
+
+/**
+ * seahorse_gpgme_cache_stamp
+ *
+ * Describes the current state of the keyring files in the GnuPG home
+ * directory. A cache written with this stamp is valid until they change.
+ *
+ * Returns: The stamp, or NULL if there's no GnuPG home directory.
+ **/
+GBytes *
+seahorse_gpgme_cache_stamp (void)
+{
+	CacheStamp *stamps;
+	const gchar *homedir;
+	GStatBuf sb;
+	gchar *path;
+	guint i;
+
+	homedir = seahorse_gpg_homedir ();
+	if (homedir == NULL)
+		return NULL;
+
+	stamps = g_new0 (CacheStamp, N_STAMP_FILES);
+	for (i = 0; i < N_STAMP_FILES; i++) {
+		path = g_build_filename (homedir, STAMP_FILES[i], NULL);
+		if (g_stat (path, &sb) == 0) {
+			stamps[i].device = sb.st_dev;
+			stamps[i].inode = sb.st_ino;
+			stamps[i].size = sb.st_size;
+			stamps[i].mtime = sb.st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+			stamps[i].mtime_nsec = sb.st_mtim.tv_nsec;
+#endif
+		}
+		g_free (path);
+	}
+
+	return g_bytes_new_take (stamps, sizeof (CacheStamp) * N_STAMP_FILES);
+}
+
+static gboolean
+cache_validate (SeahorseGpgmeCache *cache,
+                gsize length)
+{
+	const CacheHeader *header = cache->header;
+	const gchar *homedir;
+	gboolean valid;
+	GBytes *stamp;
+	guint32 i;
+
+	if (length < sizeof (CacheHeader) ||
+	    header->magic != CACHE_MAGIC ||
+	    header->version != CACHE_VERSION)
+		return FALSE;
+
+	/* The records and string table must exactly fill the file */
+	if (header->n_records > (length - sizeof (CacheHeader)) / sizeof (CacheRecord))
+		return FALSE;
+	if (sizeof (CacheHeader) + header->n_records * sizeof (CacheRecord) +
+	    header->n_strings != length)
+		return FALSE;
+
+	/* Every string must be terminated inside the table */
+	if (header->n_strings == 0 || cache->strings[0] != '\0' ||
+	    cache->strings[header->n_strings - 1] != '\0')
+		return FALSE;
+
+#define VALID_STRING(off) ((off) < header->n_strings)
+	if (!VALID_STRING (header->homedir))
+		return FALSE;
+	for (i = 0; i < header->n_records; i++) {
+		if (!VALID_STRING (cache->records[i].keyid) ||
+		    !VALID_STRING (cache->records[i].fingerprint) ||
+		    !VALID_STRING (cache->records[i].name) ||
+		    !VALID_STRING (cache->records[i].email) ||
+		    !VALID_STRING (cache->records[i].comment) ||
+		    !VALID_STRING (cache->records[i].algo) ||
+		    cache->records[i].keyid == 0)
+			return FALSE;
+	}
+#undef VALID_STRING
+
+	/* Written for this GnuPG home directory? */
+	homedir = seahorse_gpg_homedir ();
+	if (homedir == NULL || !g_str_equal (homedir, cache->strings + header->homedir))
+		return FALSE;
+
+	/* Have the keyring files changed since it was written? */
+	stamp = seahorse_gpgme_cache_stamp ();
+	valid = memcmp (g_bytes_get_data (stamp, NULL), header->stamps,
+	                sizeof (header->stamps)) == 0;
+	g_bytes_unref (stamp);
+
+	return valid;
+}
+
+/**
+ * seahorse_gpgme_cache_open
+ *
+ * Maps the key cache, if it's still valid for the current keyring files.
+ *
+ * Returns: The cache, or NULL if missing or out of date.
+ **/
+SeahorseGpgmeCache *
+seahorse_gpgme_cache_open (void)
+{
+	SeahorseGpgmeCache *cache;
+	GError *error = NULL;
+	GMappedFile *mapped;
+	const gchar *data;
+	gchar *filename;
+	gsize length;
+
+	filename = cache_filename ();
+	mapped = g_mapped_file_new (filename, FALSE, &error);
+	g_free (filename);
+
+	if (mapped == NULL) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			g_message ("couldn't open the key cache: %s", error->message);
+		g_clear_error (&error);
+		return NULL;
+	}
+
+	data = g_mapped_file_get_contents (mapped);
+	length = g_mapped_file_get_length (mapped);
+
+	cache = g_new0 (SeahorseGpgmeCache, 1);
+	cache->mapped = mapped;
+	cache->header = (const CacheHeader *)data;
+
+	if (length >= sizeof (CacheHeader)) {
+		cache->records = (const CacheRecord *)(data + sizeof (CacheHeader));
+		cache->strings = (const gchar *)(cache->records + cache->header->n_records);
+	}
+
+	if (data == NULL || !cache_validate (cache, length)) {
+		g_debug ("key cache is out of date");
+		seahorse_gpgme_cache_free (cache);
+		return NULL;
+	}
+
+	return cache;
+}
+
+guint
+seahorse_gpgme_cache_get_length (SeahorseGpgmeCache *cache)
+{
+	g_return_val_if_fail (cache != NULL, 0);
+	return cache->header->n_records;
+}
+
+/**
+ * seahorse_gpgme_cache_get_entry
+ * @cache: The cache
+ * @index: The record to read
+ * @entry: Filled in with the record
+ *
+ * The strings in the entry point into the cache, and are valid until it
+ * is freed.
+ **/
+void
+seahorse_gpgme_cache_get_entry (SeahorseGpgmeCache *cache,
+                                guint index,
+                                SeahorseGpgmeCacheEntry *entry)
+{
+	const CacheRecord *record;
+
+	g_return_if_fail (cache != NULL);
+	g_return_if_fail (index < cache->header->n_records);
+	g_return_if_fail (entry != NULL);
+
+	record = cache->records + index;
+	entry->keyid = cache->strings + record->keyid;
+	entry->fingerprint = cache->strings + record->fingerprint;
+	entry->name = cache->strings + record->name;
+	entry->email = cache->strings + record->email;
+	entry->comment = cache->strings + record->comment;
+	entry->algo = cache->strings + record->algo;
+	entry->length = record->length;
+	entry->created = record->created;
+	entry->expires = record->expires;
+	entry->usage = record->usage;
+	entry->flags = record->flags;
+	entry->validity = record->validity;
+	entry->trust = record->trust;
+}
+
+void
+seahorse_gpgme_cache_free (SeahorseGpgmeCache *cache)
+{
+	if (cache == NULL)
+		return;
+	g_mapped_file_unref (cache->mapped);
+	g_free (cache);
+}
+
+typedef struct {
+	GByteArray *strings;
+	GHashTable *offsets;
+} CacheStrings;
+
+/* Repeated strings, such as algorithms and email domains, are only stored once */
+static guint32
+cache_strings_add (CacheStrings *table,
+                   const gchar *string)
+{
+	gpointer offset;
+
+	if (string == NULL || string[0] == '\0')
+		return 0;
+
+	if (g_hash_table_lookup_extended (table->offsets, string, NULL, &offset))
+		return GPOINTER_TO_UINT (offset);
+
+	offset = GUINT_TO_POINTER (table->strings->len);
+	g_byte_array_append (table->strings, (const guint8 *)string, strlen (string) + 1);
+	g_hash_table_insert (table->offsets, g_strdup (string), offset);
+	return GPOINTER_TO_UINT (offset);
+}
+
+/* Like g_file_set_contents() but never readable by anyone else */
+static gboolean
+cache_write_private (const gchar *filename,
+                     const guint8 *data,
+                     gsize length,
+                     GError **error)
+{
+	gchar *tmpname;
+	gssize written;
+	gint errsv;
+	int fd;
+
+	tmpname = g_strdup_printf ("%s.XXXXXX", filename);
+	fd = g_mkstemp_full (tmpname, O_RDWR, 0600);
+	if (fd < 0) {
+		errsv = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+		             "Couldn't create %s: %s", tmpname, g_strerror (errsv));
+		g_free (tmpname);
+		return FALSE;
+	}
+
+	while (length > 0) {
+		written = write (fd, data, length);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			errsv = errno;
+			g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+			             "Couldn't write %s: %s", tmpname, g_strerror (errsv));
+			close (fd);
+			g_unlink (tmpname);
+			g_free (tmpname);
+			return FALSE;
+		}
+		data += written;
+		length -= written;
+	}
+
+	if (close (fd) < 0 || g_rename (tmpname, filename) < 0) {
+		errsv = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+		             "Couldn't replace %s: %s", filename, g_strerror (errsv));
+		g_unlink (tmpname);
+		g_free (tmpname);
+		return FALSE;
+	}
+
+	g_free (tmpname);
+	return TRUE;
+}
+
+/**
+ * seahorse_gpgme_cache_write
+ * @stamp: The stamp of the keyring files the keys were listed from
+ * @keys: A list of SeahorsePgpKey
+ * @error: Location to place an error
+ *
+ * Replaces the key cache with the given keys.
+ *
+ * Returns: Whether successful or not.
+ **/
+gboolean
+seahorse_gpgme_cache_write (GBytes *stamp,
+                            GList *keys,
+                            GError **error)
+{
+	CacheStrings table;
+	CacheHeader header;
+	CacheRecord record;
+	GByteArray *records;
+	SeahorsePgpKey *key;
+	GList *uids, *subkeys;
+	const gchar *homedir;
+	gchar *filename;
+	gchar *dirname;
+	gboolean ret;
+	GList *l;
+
+	g_return_val_if_fail (stamp != NULL, FALSE);
+	g_return_val_if_fail (g_bytes_get_size (stamp) == sizeof (header.stamps), FALSE);
+
+	homedir = seahorse_gpg_homedir ();
+	g_return_val_if_fail (homedir != NULL, FALSE);
+
+	memset (&header, 0, sizeof (header));
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	memcpy (header.stamps, g_bytes_get_data (stamp, NULL), sizeof (header.stamps));
+
+	table.strings = g_byte_array_new ();
+	table.offsets = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	g_byte_array_append (table.strings, (const guint8 *)"", 1);
+	header.homedir = cache_strings_add (&table, homedir);
+
+	records = g_byte_array_new ();
+	for (l = keys; l != NULL; l = g_list_next (l)) {
+		key = SEAHORSE_PGP_KEY (l->data);
+		subkeys = seahorse_pgp_key_get_subkeys (key);
+		if (subkeys == NULL)
+			continue;
+		uids = seahorse_pgp_key_get_uids (key);
+
+		memset (&record, 0, sizeof (record));
+		record.keyid = cache_strings_add (&table, seahorse_pgp_key_get_keyid (key));
+		record.fingerprint = cache_strings_add (&table, seahorse_pgp_key_get_fingerprint (key));
+		if (uids != NULL) {
+			record.name = cache_strings_add (&table, seahorse_pgp_uid_get_name (uids->data));
+			record.email = cache_strings_add (&table, seahorse_pgp_uid_get_email (uids->data));
+			record.comment = cache_strings_add (&table, seahorse_pgp_uid_get_comment (uids->data));
+		}
+		record.algo = cache_strings_add (&table, seahorse_pgp_key_get_algo (key));
+		record.length = seahorse_pgp_key_get_length (key);
+		record.created = seahorse_pgp_subkey_get_created (subkeys->data);
+		record.expires = seahorse_pgp_key_get_expires (key);
+		record.usage = seahorse_object_get_usage (SEAHORSE_OBJECT (key));
+		record.flags = seahorse_object_get_flags (SEAHORSE_OBJECT (key));
+		record.validity = seahorse_pgp_key_get_validity (key);
+		record.trust = seahorse_pgp_key_get_trust (key);
+
+		if (record.keyid != 0) {
+			g_byte_array_append (records, (const guint8 *)&record, sizeof (record));
+			header.n_records++;
+		}
+	}
+
+	header.n_strings = table.strings->len;
+
+	/* Header and records go before the strings */
+	g_byte_array_prepend (records, (const guint8 *)&header, sizeof (header));
+	g_byte_array_append (records, table.strings->data, table.strings->len);
+	g_byte_array_free (table.strings, TRUE);
+	g_hash_table_destroy (table.offsets);
+
+	filename = cache_filename ();
+	dirname = g_path_get_dirname (filename);
+	g_mkdir_with_parents (dirname, 0700);
+	g_free (dirname);
+
+	ret = cache_write_private (filename, records->data, records->len, error);
+	g_byte_array_free (records, TRUE);
+	g_free (filename);
+
+	return ret;
+}
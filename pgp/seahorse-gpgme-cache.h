@@ -0,0 +1,68 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * An on-disk cache of the key metadata shown in the key manager.
+ *
+ * - Lives in the user cache directory and is memory mapped when read.
+ * - Is only valid as long as the GnuPG keyring files it was written for
+ *   have the same device, inode, size and modification time.
+ * - Lets the keyring show its keys at startup without running gpg.
+ */
+
+#ifndef __SEAHORSE_GPGME_CACHE_H__
+#define __SEAHORSE_GPGME_CACHE_H__
+
+#include <glib.h>
+
+#include "seahorse-pgp-key.h"
+
+typedef struct _SeahorseGpgmeCache SeahorseGpgmeCache;
+
+typedef struct {
+	const gchar *keyid;
+	const gchar *fingerprint;
+	const gchar *name;
+	const gchar *email;
+	const gchar *comment;
+	const gchar *algo;
+	guint length;
+	gulong created;
+	gulong expires;
+	SeahorseUsage usage;
+	guint flags;
+	SeahorseValidity validity;
+	SeahorseValidity trust;
+} SeahorseGpgmeCacheEntry;
+
+GBytes *              seahorse_gpgme_cache_stamp        (void);
+
+SeahorseGpgmeCache *  seahorse_gpgme_cache_open         (void);
+
+guint                 seahorse_gpgme_cache_get_length   (SeahorseGpgmeCache *cache);
+
+void                  seahorse_gpgme_cache_get_entry    (SeahorseGpgmeCache *cache,
+                                                         guint index,
+                                                         SeahorseGpgmeCacheEntry *entry);
+
+void                  seahorse_gpgme_cache_free         (SeahorseGpgmeCache *cache);
+
+gboolean              seahorse_gpgme_cache_write        (GBytes *stamp,
+                                                         GList *keys,
+                                                         GError **error);
+
+#endif /* __SEAHORSE_GPGME_CACHE_H__ */
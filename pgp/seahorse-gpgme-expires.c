@@ -36,6 +36,22 @@ void              on_gpgme_expire_ok_clicked             (GtkButton *button,
 void              on_gpgme_expire_toggled                (GtkWidget *widget,
                                                           gpointer user_data);
 
+static void
+on_set_expires_complete (GObject *source,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_set_expires_finish (SEAHORSE_GPGME_SUBKEY (source),
+	                                               result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't change expiry date"));
+
+	seahorse_widget_destroy (swidget);
+	g_object_unref (swidget);
+}
+
 G_MODULE_EXPORT void
 on_gpgme_expire_ok_clicked (GtkButton *button,
                             gpointer user_data)
@@ -43,7 +59,6 @@ on_gpgme_expire_ok_clicked (GtkButton *button,
 	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
 	GtkWidget *widget; 
 	SeahorseGpgmeSubkey *subkey;
-	gpgme_error_t err;
 	time_t expiry = 0;
 	struct tm when;
 	
@@ -66,20 +81,17 @@ on_gpgme_expire_ok_clicked (GtkButton *button,
 		}
 	}
 	
+	if (expiry == (time_t)seahorse_pgp_subkey_get_expires (SEAHORSE_PGP_SUBKEY (subkey))) {
+		seahorse_widget_destroy (swidget);
+		return;
+	}
+
+	/* The dialog stays up, insensitive, until gpg is done */
 	widget = seahorse_widget_get_widget (swidget, "all-controls");
 	gtk_widget_set_sensitive (widget, FALSE);
-	g_object_ref (swidget);
-	g_object_ref (subkey);
-	
-	if (expiry != (time_t)seahorse_pgp_subkey_get_expires (SEAHORSE_PGP_SUBKEY (subkey))) {
-		err = seahorse_gpgme_key_op_set_expires (subkey, expiry);
-		if (!GPG_IS_OK (err))
-			seahorse_gpgme_handle_error (err, _("Couldn't change expiry date"));
-	}
-    
-	g_object_unref (subkey);
-	g_object_unref (swidget);
-	seahorse_widget_destroy (swidget);
+	seahorse_gpgme_key_op_set_expires_async (subkey, expiry, NULL,
+	                                         on_set_expires_complete,
+	                                         g_object_ref (swidget));
 }
 
 G_MODULE_EXPORT void
@@ -312,6 +312,30 @@ on_keyring_export_complete (gpgme_error_t gerr,
 	return TRUE; /* call this source again */
 }
 
+#ifdef GPGME_EXPORT_MODE_SECRET
+
+static gboolean
+on_keyring_export_secret_complete (gpgme_error_t gerr,
+                                   gpointer user_data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	GpgmeExportClosure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
+	guint i;
+
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		g_simple_async_result_take_error (res, error);
+	} else {
+		for (i = 0; i < closure->keyids->len - 1; i++)
+			seahorse_progress_end (closure->cancellable, closure->keyids->pdata[i]);
+	}
+
+	g_simple_async_result_complete (res);
+	return FALSE; /* don't call again */
+}
+
+#endif /* GPGME_EXPORT_MODE_SECRET */
+
 static void
 seahorse_gpgme_exporter_export_async (SeahorseExporter *exporter,
                                       GCancellable *cancellable,
@@ -327,6 +351,9 @@ seahorse_gpgme_exporter_export_async (SeahorseExporter *exporter,
 	gchar *keyid;
 	GSource *gsource;
 	GList *l;
+#ifdef GPGME_EXPORT_MODE_SECRET
+	guint i;
+#endif
 
 	res = g_simple_async_result_new (G_OBJECT (exporter), callback, user_data,
 	                                 seahorse_gpgme_exporter_export_async);
@@ -360,11 +387,31 @@ seahorse_gpgme_exporter_export_async (SeahorseExporter *exporter,
 	if (self->secret) {
 		g_return_if_fail (self->armor == TRUE);
 		g_ptr_array_add (closure->keyids, NULL);
+#ifdef GPGME_EXPORT_MODE_SECRET
+		gsource = seahorse_gpgme_gsource_new (closure->gctx, cancellable);
+		g_source_set_callback (gsource, (GSourceFunc)on_keyring_export_secret_complete,
+		                       g_object_ref (res), g_object_unref);
+
+		/* All the keys in one go, streamed straight into the output */
+		gerr = gpgme_op_export_ext_start (closure->gctx, (const gchar **)closure->keyids->pdata,
+		                                  GPGME_EXPORT_MODE_SECRET, closure->data);
+		if (seahorse_gpgme_propagate_error (gerr, &error)) {
+			g_simple_async_result_take_error (res, error);
+			g_simple_async_result_complete_in_idle (res);
+		} else {
+			for (i = 0; i < closure->keyids->len - 1; i++)
+				seahorse_progress_begin (closure->cancellable, closure->keyids->pdata[i]);
+			g_source_attach (gsource, g_main_context_default ());
+		}
+
+		g_source_unref (gsource);
+#else
 		gerr = seahorse_gpg_op_export_secret (closure->gctx, (const gchar **)closure->keyids->pdata,
 		                                      closure->data);
 		if (seahorse_gpgme_propagate_error (gerr, &error))
 			g_simple_async_result_take_error (res, error);
 		g_simple_async_result_complete_in_idle (res);
+#endif
 		g_object_unref (res);
 		return;
 	}
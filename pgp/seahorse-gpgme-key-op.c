@@ -346,79 +346,156 @@ seahorse_gpgme_key_op_edit (gpointer data, gpgme_status_code_t status,
 	return parms->err;
 }
 
-/* Common edit operation */
-static gpgme_error_t
-edit_gpgme_key (gpgme_ctx_t ctx,
-                gpgme_key_t key,
-                SeahorseEditParm *parms)
-{
-	gboolean own_context = FALSE;
+/*
+ * The edit engine. The SeahorseEditParm state machines are driven by
+ * gpgme_op_edit_start(), with the status callbacks dispatched from the
+ * main loop through a seahorse_gpgme_gsource_new() source.
+ */
+
+typedef struct {
+	GCancellable *cancellable;
+	gpgme_ctx_t gctx;
+	gpgme_key_t key;
 	gpgme_data_t out;
-	gpgme_error_t gerr;
+	SeahorseEditParm *parms;
+	GDestroyNotify destroy;
+} key_op_edit_closure;
 
-	g_assert (key);
-	g_assert (parms);
+static void
+key_op_edit_free (gpointer data)
+{
+	key_op_edit_closure *closure = data;
+	g_clear_object (&closure->cancellable);
+	if (closure->gctx)
+		gpgme_release (closure->gctx);
+	if (closure->out)
+		seahorse_gpgme_data_release (closure->out);
+	if (closure->key)
+		gpgme_key_unref (closure->key);
+	if (closure->destroy)
+		(closure->destroy) (closure->parms->data);
+	g_free (closure->parms);
+	g_free (closure);
+}
 
-	gpgme_key_ref (key);
+static gboolean
+on_key_op_edit_complete (gpgme_error_t gerr,
+                         gpointer user_data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	key_op_edit_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
 
-	if (ctx == NULL) {
-		ctx = seahorse_gpgme_keyring_new_context (&gerr);
-		if (ctx == NULL)
-			return gerr;
-		own_context = TRUE;
+	if (gpgme_err_code (gerr) == GPG_ERR_BAD_PASSPHRASE) {
+		seahorse_util_show_error (NULL, _("Wrong password"), _("This was the third time you entered a wrong password. Please try again."));
 	}
 
-	out = seahorse_gpgme_data_new ();
-
-	/* do edit callback, release data */
-	gerr = gpgme_op_edit (ctx, key, seahorse_gpgme_key_op_edit, parms, out);
-
-	if (gpgme_err_code (gerr) == GPG_ERR_BAD_PASSPHRASE) {
-		seahorse_util_show_error(NULL, _("Wrong password"), _("This was the third time you entered a wrong password. Please try again."));
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		g_simple_async_result_take_error (res, error);
+	} else {
+		seahorse_gpgme_key_refresh_matching (closure->key);
 	}
 
-	seahorse_gpgme_data_release (out);
-	if (own_context)
-		gpgme_release (ctx);
-	gpgme_key_unref (key);
-	return gerr;
+	seahorse_progress_end (closure->cancellable, res);
+	g_simple_async_result_complete (res);
+	return FALSE; /* don't call again */
 }
 
-static gpgme_error_t
-edit_refresh_gpgme_key (gpgme_ctx_t ctx, gpgme_key_t key, SeahorseEditParm *parms)
-{
-	gpgme_error_t gerr;
-	
-	gerr = edit_gpgme_key (ctx, key, parms);
-	if (GPG_IS_OK (gerr))
-		seahorse_gpgme_key_refresh_matching (key);
-	
-	return gerr;
+/*
+ * Prepares an asynchronous edit. Takes ownership of @parms, and @destroy
+ * is called on its data once the operation is done with it.
+ */
+static GSimpleAsyncResult *
+edit_result_new (gpointer source,
+                 gpointer source_tag,
+                 SeahorseEditParm *parms,
+                 GDestroyNotify destroy,
+                 GCancellable *cancellable,
+                 GAsyncReadyCallback callback,
+                 gpointer user_data)
+{
+	key_op_edit_closure *closure;
+	GSimpleAsyncResult *res;
+
+	res = g_simple_async_result_new (G_OBJECT (source), callback, user_data, source_tag);
+	closure = g_new0 (key_op_edit_closure, 1);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	closure->parms = parms;
+	closure->destroy = destroy;
+	g_simple_async_result_set_op_res_gpointer (res, closure, key_op_edit_free);
+
+	return res;
 }
 
-static gpgme_error_t
-edit_key (SeahorseGpgmeKey *pkey, SeahorseEditParm *parms)
+/* Starts the edit of @key prepared in @res, and consumes @res */
+static void
+edit_gpgme_key_start (GSimpleAsyncResult *res,
+                      gpgme_key_t key)
 {
-	SeahorseGpgmeKeyring *keyring;
-	gpgme_error_t gerr;
-	gpgme_key_t key;
-	gpgme_ctx_t ctx;
+	key_op_edit_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
+	gpgme_error_t gerr = 0;
+	GSource *gsource = NULL;
 
-	keyring = SEAHORSE_GPGME_KEYRING (seahorse_object_get_place (SEAHORSE_OBJECT (pkey)));
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEYRING (keyring), GPG_E (GPG_ERR_INV_KEYRING));
+	if (key == NULL) {
+		g_simple_async_result_set_error (res, SEAHORSE_GPGME_ERROR, GPG_ERR_INV_VALUE,
+		                                 _("The key could not be loaded"));
+		g_simple_async_result_complete_in_idle (res);
+		g_object_unref (res);
+		return;
+	}
 
-	g_object_ref (pkey);
+	closure->key = key;
+	gpgme_key_ref (key);
 
-	seahorse_util_wait_until ((key = seahorse_gpgme_key_get_public (pkey)) != NULL);
+	closure->gctx = seahorse_gpgme_keyring_new_context (&gerr);
 
-	ctx = seahorse_gpgme_keyring_new_context (&gerr);
-	if (ctx != NULL) {
-		gerr = edit_refresh_gpgme_key (ctx, key, parms);
-		gpgme_release (ctx);
+	seahorse_progress_prep_and_begin (closure->cancellable, res, NULL);
+
+	if (GPG_IS_OK (gerr)) {
+		gsource = seahorse_gpgme_gsource_new (closure->gctx, closure->cancellable);
+		g_source_set_callback (gsource, (GSourceFunc)on_key_op_edit_complete,
+		                       g_object_ref (res), g_object_unref);
+
+		closure->out = seahorse_gpgme_data_new ();
+		gerr = gpgme_op_edit_start (closure->gctx, key, seahorse_gpgme_key_op_edit,
+		                            closure->parms, closure->out);
 	}
 
-	g_object_unref (pkey);
-	return gerr;
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		seahorse_progress_end (closure->cancellable, res);
+		g_simple_async_result_take_error (res, error);
+		g_simple_async_result_complete_in_idle (res);
+	} else {
+		g_source_attach (gsource, g_main_context_default ());
+	}
+
+	if (gsource)
+		g_source_unref (gsource);
+	g_object_unref (res);
+}
+
+/* Edits the public part of the key, and refreshes it when done */
+static void
+edit_key_start (SeahorseGpgmeKey *pkey,
+                GSimpleAsyncResult *res)
+{
+	edit_gpgme_key_start (res, seahorse_gpgme_key_get_public (pkey));
+}
+
+static gboolean
+edit_key_finish (gpointer source,
+                 GAsyncResult *result,
+                 gpointer source_tag,
+                 GError **error)
+{
+	g_return_val_if_fail (g_simple_async_result_is_valid (result, G_OBJECT (source),
+	                      source_tag), FALSE);
+
+	if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result), error))
+		return FALSE;
+
+	return TRUE;
 }
 
 typedef struct
@@ -585,83 +662,300 @@ sign_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-static gpgme_error_t
-sign_process (gpgme_key_t signed_key, gpgme_key_t signing_key, guint sign_index, 
-              SeahorseSignCheck check, SeahorseSignOptions options)
+static void
+sign_parm_free (gpointer data)
 {
-	SeahorseEditParm *parms;
-	SignParm sign_parm;
-	gpgme_ctx_t ctx;
-	gpgme_error_t gerr;
+	SignParm *sign_parm = data;
+	g_free (sign_parm->command);
+	g_free (sign_parm);
+}
 
-	ctx = seahorse_gpgme_keyring_new_context (&gerr);
-	if (ctx == NULL)
-		return gerr;
+static SeahorseEditParm *
+sign_parm_new (guint sign_index,
+               SeahorseSignCheck check,
+               SeahorseSignOptions options)
+{
+	SignParm *sign_parm;
 
-        gerr = gpgme_signers_add (ctx, signing_key);
-        if (!GPG_IS_OK (gerr))
-        	return gerr;
-	
-	sign_parm.index = sign_index;
-	sign_parm.expire = ((options & SIGN_EXPIRES) != 0);
-	sign_parm.check = check;
-	sign_parm.command = g_strdup_printf ("%s%ssign", 
-	                                     (options & SIGN_NO_REVOKE) ? "nr" : "",
-	                                     (options & SIGN_LOCAL) ? "l" : "");
-
-	parms = seahorse_edit_parm_new (SIGN_START, sign_action, sign_transit, &sign_parm);
-
-	gerr =  edit_refresh_gpgme_key (ctx, signed_key, parms);
-	g_free (sign_parm.command);
-	g_free (parms);
-	 
-	gpgme_release (ctx);
+	sign_parm = g_new0 (SignParm, 1);
+	sign_parm->index = sign_index;
+	sign_parm->expire = ((options & SIGN_EXPIRES) != 0);
+	sign_parm->check = check;
+	sign_parm->command = g_strdup_printf ("%s%ssign",
+	                                      (options & SIGN_NO_REVOKE) ? "nr" : "",
+	                                      (options & SIGN_LOCAL) ? "l" : "");
 
-	return gerr;
+	return seahorse_edit_parm_new (SIGN_START, sign_action, sign_transit, sign_parm);
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_sign_uid (SeahorseGpgmeUid *uid,  SeahorseGpgmeKey *signer, 
-                                SeahorseSignCheck check, SeahorseSignOptions options)
+/*
+ * Signing many keys at once, for example after a key signing party. The
+ * keys are signed one after another in a single gpg context which already
+ * has the signer set up, so gpg-agent only needs to ask for the passphrase
+ * once. All signed keys are refreshed together at the end.
+ */
+
+typedef struct {
+	GCancellable *cancellable;
+	gpgme_ctx_t gctx;
+	GPtrArray *objects;
+	gint at;
+	SeahorseSignCheck check;
+	SeahorseSignOptions options;
+	SeahorseEditParm *parms;
+	gpgme_data_t out;
+	gpgme_key_t key;
+	GPtrArray *signed_keys;
+	guint already_signed;
+	GError *error;
+	gboolean starting;
+} key_op_sign_multiple_closure;
+
+static void
+key_op_sign_multiple_clear_current (key_op_sign_multiple_closure *closure)
 {
-	gpgme_key_t signing_key;
-	gpgme_key_t signed_key;
-	guint sign_index;
-	
-	seahorse_gpgme_key_get_private (signer);
+	if (closure->parms) {
+		sign_parm_free (closure->parms->data);
+		g_free (closure->parms);
+		closure->parms = NULL;
+	}
+	if (closure->out) {
+		seahorse_gpgme_data_release (closure->out);
+		closure->out = NULL;
+	}
+	if (closure->key) {
+		gpgme_key_unref (closure->key);
+		closure->key = NULL;
+	}
+}
 
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_UID (uid), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (signer), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	signing_key = seahorse_gpgme_key_get_private (signer);
-	g_return_val_if_fail (signing_key, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	signed_key = seahorse_gpgme_uid_get_pubkey (uid);
-	g_return_val_if_fail (signing_key, GPG_E (GPG_ERR_INV_VALUE));
-	
-	sign_index = seahorse_gpgme_uid_get_actual_index (uid);
-	
-	return sign_process (signed_key, signing_key, sign_index, check, options);
+static void
+key_op_sign_multiple_free (gpointer data)
+{
+	key_op_sign_multiple_closure *closure = data;
+	key_op_sign_multiple_clear_current (closure);
+	g_clear_object (&closure->cancellable);
+	if (closure->gctx)
+		gpgme_release (closure->gctx);
+	g_ptr_array_free (closure->objects, TRUE);
+	g_ptr_array_free (closure->signed_keys, TRUE);
+	g_clear_error (&closure->error);
+	g_free (closure);
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_sign (SeahorseGpgmeKey *pkey, SeahorseGpgmeKey *signer, 
-                            SeahorseSignCheck check, SeahorseSignOptions options)
+/* Ends the progress of the keys from @from on, which won't be signed */
+static void
+key_op_sign_multiple_end_progress (key_op_sign_multiple_closure *closure,
+                                   gint from)
+{
+	GObject *object;
+	gint i;
+
+	for (i = from; i < (gint)closure->objects->len; i++) {
+		object = closure->objects->pdata[i];
+		seahorse_progress_begin (closure->cancellable, object);
+		seahorse_progress_end (closure->cancellable, object);
+	}
+}
+
+static void
+key_op_sign_multiple_done (GSimpleAsyncResult *res,
+                           key_op_sign_multiple_closure *closure)
 {
+	/* Never complete from inside seahorse_gpgme_key_op_sign_multiple_async() */
+	if (closure->starting)
+		g_simple_async_result_complete_in_idle (res);
+	else
+		g_simple_async_result_complete (res);
+}
+
+static gboolean
+on_key_op_sign_multiple_complete (gpgme_error_t gerr,
+                                  gpointer user_data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	key_op_sign_multiple_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
+	gpgme_key_t key = NULL;
+	GObject *object;
+	guint sign_index = 0;
+	guint i;
+
+	if (closure->at >= 0) {
+		object = closure->objects->pdata[closure->at];
+		seahorse_progress_end (closure->cancellable, object);
+
+		switch (gpgme_err_code (gerr)) {
+		case GPG_ERR_NO_ERROR:
+			g_ptr_array_add (closure->signed_keys, closure->key);
+			closure->key = NULL;
+			break;
+
+		/* Keys which were already signed don't stop the others */
+		case GPG_ERR_EALREADY:
+			closure->already_signed++;
+			break;
+
+		/* Retrying the next key would only prompt again */
+		case GPG_ERR_CANCELED:
+		case GPG_ERR_BAD_PASSPHRASE:
+			key_op_sign_multiple_end_progress (closure, closure->at + 1);
+			seahorse_gpgme_propagate_error (gerr, &error);
+			g_simple_async_result_take_error (res, error);
+			key_op_sign_multiple_done (res, closure);
+			return FALSE; /* don't call again */
+
+		/* Other failures are reported once all the keys are done */
+		default:
+			g_message ("couldn't sign key: %s", gpgme_strerror (gerr));
+			if (closure->error == NULL)
+				seahorse_gpgme_propagate_error (gerr, &closure->error);
+			break;
+		}
+
+		key_op_sign_multiple_clear_current (closure);
+	}
+
+	for (closure->at++; closure->at < (gint)closure->objects->len; closure->at++) {
+		object = closure->objects->pdata[closure->at];
+		if (SEAHORSE_IS_GPGME_UID (object)) {
+			key = seahorse_gpgme_uid_get_pubkey (SEAHORSE_GPGME_UID (object));
+			sign_index = seahorse_gpgme_uid_get_actual_index (SEAHORSE_GPGME_UID (object));
+		} else {
+			key = seahorse_gpgme_key_get_public (SEAHORSE_GPGME_KEY (object));
+			sign_index = 0;
+		}
+
+		if (key != NULL)
+			break;
+
+		seahorse_progress_begin (closure->cancellable, object);
+		seahorse_progress_end (closure->cancellable, object);
+	}
+
+	/* All done, refresh the signed keys in one go */
+	if (closure->at == (gint)closure->objects->len) {
+		for (i = 0; i < closure->signed_keys->len; i++)
+			seahorse_gpgme_key_refresh_matching (closure->signed_keys->pdata[i]);
+		if (closure->error == NULL && closure->already_signed > 0 &&
+		    closure->already_signed == closure->objects->len)
+			seahorse_gpgme_propagate_error (GPG_E (GPG_ERR_EALREADY), &closure->error);
+		if (closure->error) {
+			g_simple_async_result_take_error (res, closure->error);
+			closure->error = NULL;
+		}
+		key_op_sign_multiple_done (res, closure);
+		return FALSE; /* don't run this again */
+	}
+
+	/* Sign the next key in the list */
+	closure->key = key;
+	gpgme_key_ref (key);
+	closure->parms = sign_parm_new (sign_index, closure->check, closure->options);
+	closure->out = seahorse_gpgme_data_new ();
+
+	gerr = gpgme_op_edit_start (closure->gctx, key, seahorse_gpgme_key_op_edit,
+	                            closure->parms, closure->out);
+
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		key_op_sign_multiple_end_progress (closure, closure->at);
+		g_simple_async_result_take_error (res, error);
+		key_op_sign_multiple_done (res, closure);
+		return FALSE; /* don't run this again */
+	}
+
+	seahorse_progress_begin (closure->cancellable, object);
+	return TRUE; /* call this source again */
+}
+
+/**
+ * seahorse_gpgme_key_op_sign_multiple_async:
+ * @objects: (element-type SeahorseObject): #SeahorseGpgmeKey and
+ *           #SeahorseGpgmeUid objects to sign
+ * @signer: The private key to sign with
+ * @check: How carefully the keys were checked
+ * @options: Signature options
+ *
+ * Signs all @objects with @signer. Keys that were already signed by
+ * @signer are skipped, and a failure to sign one key does not stop the
+ * others from being signed. If every key was already signed, this fails
+ * with %GPG_ERR_EALREADY.
+ **/
+void
+seahorse_gpgme_key_op_sign_multiple_async (GList *objects,
+                                           SeahorseGpgmeKey *signer,
+                                           SeahorseSignCheck check,
+                                           SeahorseSignOptions options,
+                                           GCancellable *cancellable,
+                                           GAsyncReadyCallback callback,
+                                           gpointer user_data)
+{
+	key_op_sign_multiple_closure *closure;
+	GSimpleAsyncResult *res;
 	gpgme_key_t signing_key;
-	gpgme_key_t signed_key;
-	
-	seahorse_gpgme_key_get_private (signer);
+	GError *error = NULL;
+	gpgme_error_t gerr = 0;
+	GSource *gsource;
+	GList *l;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (signer));
+	for (l = objects; l != NULL; l = g_list_next (l))
+		g_return_if_fail (SEAHORSE_IS_GPGME_KEY (l->data) || SEAHORSE_IS_GPGME_UID (l->data));
+
+	res = g_simple_async_result_new (G_OBJECT (signer), callback, user_data,
+	                                 seahorse_gpgme_key_op_sign_multiple_async);
+	closure = g_new0 (key_op_sign_multiple_closure, 1);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	closure->objects = g_ptr_array_new_with_free_func (g_object_unref);
+	closure->signed_keys = g_ptr_array_new_with_free_func ((GDestroyNotify)gpgme_key_unref);
+	closure->check = check;
+	closure->options = options;
+	closure->at = -1;
+	g_simple_async_result_set_op_res_gpointer (res, closure, key_op_sign_multiple_free);
+
+	for (l = objects; l != NULL; l = g_list_next (l)) {
+		seahorse_progress_prep (closure->cancellable, l->data, _("Signing %s"),
+		                        seahorse_object_get_label (l->data));
+		g_ptr_array_add (closure->objects, g_object_ref (l->data));
+	}
 
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (signer), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
 	signing_key = seahorse_gpgme_key_get_private (signer);
-	g_return_val_if_fail (signing_key, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	signed_key = seahorse_gpgme_key_get_public (pkey);
+	if (signing_key == NULL)
+		gerr = GPG_E (GPG_ERR_WRONG_KEY_USAGE);
+
+	if (gerr == 0)
+		closure->gctx = seahorse_gpgme_keyring_new_context (&gerr);
+	if (gerr == 0)
+		gerr = gpgme_signers_add (closure->gctx, signing_key);
+
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		key_op_sign_multiple_end_progress (closure, 0);
+		g_simple_async_result_take_error (res, error);
+		g_simple_async_result_complete_in_idle (res);
+		g_object_unref (res);
+		return;
+	}
+
+	gsource = seahorse_gpgme_gsource_new (closure->gctx, cancellable);
+	g_source_set_callback (gsource, (GSourceFunc)on_key_op_sign_multiple_complete,
+	                       g_object_ref (res), g_object_unref);
+
+	/* Get things started */
+	closure->starting = TRUE;
+	if (on_key_op_sign_multiple_complete (0, res))
+		g_source_attach (gsource, g_main_context_default ());
+	closure->starting = FALSE;
+
+	g_source_unref (gsource);
+	g_object_unref (res);
+}
 
-	return sign_process (signed_key, signing_key, 0, check, options);
+gboolean
+seahorse_gpgme_key_op_sign_multiple_finish (SeahorseGpgmeKey *signer,
+                                            GAsyncResult *result,
+                                            GError **error)
+{
+	return edit_key_finish (signer, result, seahorse_gpgme_key_op_sign_multiple_async, error);
 }
 
 typedef enum {
@@ -769,20 +1063,28 @@ edit_pass_transit (guint current_state, gpgme_status_code_t status,
     return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_change_pass (SeahorseGpgmeKey *pkey)
+void
+seahorse_gpgme_key_op_change_pass_async (SeahorseGpgmeKey *pkey,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
 {
 	SeahorseEditParm *parms;
-	gpgme_error_t err;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));    
-	g_return_val_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY);
+
 	parms = seahorse_edit_parm_new (PASS_START, edit_pass_action, edit_pass_transit, NULL);
-	
-	err = edit_key (pkey, parms);
-	
-	return err;
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_change_pass_async,
+	                                       parms, NULL, cancellable, callback, user_data));
+}
+
+gboolean
+seahorse_gpgme_key_op_change_pass_finish (SeahorseGpgmeKey *pkey,
+                                          GAsyncResult *result,
+                                          GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_change_pass_async, error);
 }
 
 typedef enum
@@ -881,139 +1183,16 @@ edit_trust_transit (guint current_state, gpgme_status_code_t status,
                 g_return_val_if_reached (TRUST_ERROR);
 			}
 			break;
-		/* error, go to quit */
-		case TRUST_ERROR:
-			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT))
-				next_state = TRUST_QUIT;
-			else
-				next_state = TRUST_ERROR;
-			break;
-		default:
-            *err = GPG_E (GPG_ERR_GENERAL);
-            g_return_val_if_reached (TRUST_ERROR);
-			break;
-	}
-	
-	return next_state;
-}
-
-/**
- * seahorse_gpgme_key_op_set_trust:
- * @pkey: #SeahorseGpgmeKey whose trust will be changed
- * @trust: New trust value that must be at least #SEAHORSE_VALIDITY_NEVER.
- * If @pkey is a #SeahorseKeyPair, then @trust cannot be #SEAHORSE_VALIDITY_UNKNOWN.
- * If @pkey is not a #SeahorseKeyPair, then @trust cannot be #SEAHORSE_VALIDITY_ULTIMATE.
- *
- * Tries to change the owner trust of @pkey to @trust.
- *
- * Returns: Error value
- **/
-gpgme_error_t
-seahorse_gpgme_key_op_set_trust (SeahorseGpgmeKey *pkey, SeahorseValidity trust)
-{
-	SeahorseEditParm *parms;
-	gint menu_choice;
-
-	g_debug ("[GPGME_KEY_OP] set_trust: trust = %i", trust);
-
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (trust >= SEAHORSE_VALIDITY_NEVER, GPG_E (GPG_ERR_INV_VALUE));
-	g_return_val_if_fail (seahorse_gpgme_key_get_trust (pkey) != trust, GPG_E (GPG_ERR_INV_VALUE));
-	
-	if (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY)
-		g_return_val_if_fail (trust != SEAHORSE_VALIDITY_UNKNOWN, GPG_E (GPG_ERR_INV_VALUE));
-	else
-		g_return_val_if_fail (trust != SEAHORSE_VALIDITY_ULTIMATE, GPG_E (GPG_ERR_INV_VALUE));
-	
-	switch (trust) {
-        case SEAHORSE_VALIDITY_NEVER:
-            menu_choice = GPG_NEVER;
-            break;
-        case SEAHORSE_VALIDITY_UNKNOWN:
-            menu_choice = GPG_UNKNOWN;
-            break;
-        case SEAHORSE_VALIDITY_MARGINAL:
-            menu_choice = GPG_MARGINAL;
-            break;
-        case SEAHORSE_VALIDITY_FULL:
-            menu_choice = GPG_FULL;
-            break;
-        case SEAHORSE_VALIDITY_ULTIMATE:
-            menu_choice = GPG_ULTIMATE;
-            break;
-        default:
-            menu_choice = 1;
-    }
-	
-	parms = seahorse_edit_parm_new (TRUST_START, edit_trust_action,
-		edit_trust_transit, GINT_TO_POINTER (menu_choice));
-	
-	return edit_key (pkey, parms);
-}
-
-typedef enum {
-	DISABLE_START,
-	DISABLE_COMMAND,
-	DISABLE_QUIT,
-	DISABLE_ERROR
-} DisableState;
-
-/* action helper for disable/enable a key */
-static gpgme_error_t
-edit_disable_action (guint state, gpointer data, int fd)
-{
-	const gchar *command = data;
-	
-	switch (state) {
-		case DISABLE_COMMAND:
-            PRINT ((fd, command));
-			break;
-		case DISABLE_QUIT:
-            PRINT ((fd, QUIT));
-			break;
-		default:
-			break;
-	}
-	
-    PRINT ((fd, "\n"));
-	return GPG_OK;
-}
-
-/* transition helper for disable/enable a key */
-static guint
-edit_disable_transit (guint current_state, gpgme_status_code_t status,
-		      const gchar *args, gpointer data, gpgme_error_t *err)
-{
-	guint next_state;
-	
-	switch (current_state) {
-		/* start, do command */
-		case DISABLE_START:
-			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT))
-				next_state = DISABLE_COMMAND;
-			else {
-                *err = GPG_E (GPG_ERR_GENERAL);
-                g_return_val_if_reached (DISABLE_ERROR);
-			}
-			break;
-		/* did command, quit */
-		case DISABLE_COMMAND:
-			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT))
-				next_state = DISABLE_QUIT;
-			else {
-                *err = GPG_E (GPG_ERR_GENERAL);
-                g_return_val_if_reached (DISABLE_ERROR);
-			}
-		/* error, quit */
-		case DISABLE_ERROR:
+		/* error, go to quit */
+		case TRUST_ERROR:
 			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT))
-				next_state = DISABLE_QUIT;
+				next_state = TRUST_QUIT;
 			else
-				next_state = DISABLE_ERROR;
+				next_state = TRUST_ERROR;
 			break;
 		default:
             *err = GPG_E (GPG_ERR_GENERAL);
-            g_return_val_if_reached (DISABLE_ERROR);
+            g_return_val_if_reached (TRUST_ERROR);
 			break;
 	}
 	
@@ -1021,31 +1200,65 @@ edit_disable_transit (guint current_state, gpgme_status_code_t status,
 }
 
 /**
- * seahorse_gpgme_key_op_set_disabled:
- * @skey: #SeahorseKey to change
- * @disabled: New disabled state
+ * seahorse_gpgme_key_op_set_trust:
+ * @pkey: #SeahorseGpgmeKey whose trust will be changed
+ * @trust: New trust value that must be at least #SEAHORSE_VALIDITY_NEVER.
+ * If @pkey is a #SeahorseKeyPair, then @trust cannot be #SEAHORSE_VALIDITY_UNKNOWN.
+ * If @pkey is not a #SeahorseKeyPair, then @trust cannot be #SEAHORSE_VALIDITY_ULTIMATE.
  *
- * Tries to change disabled state of @skey to @disabled.
+ * Tries to change the owner trust of @pkey to @trust.
  *
  * Returns: Error value
  **/
-gpgme_error_t
-seahorse_gpgme_key_op_set_disabled (SeahorseGpgmeKey *pkey, gboolean disabled)
+static gint
+trust_menu_choice (SeahorseValidity trust)
+{
+	switch (trust) {
+        case SEAHORSE_VALIDITY_NEVER:
+            return GPG_NEVER;
+        case SEAHORSE_VALIDITY_UNKNOWN:
+            return GPG_UNKNOWN;
+        case SEAHORSE_VALIDITY_MARGINAL:
+            return GPG_MARGINAL;
+        case SEAHORSE_VALIDITY_FULL:
+            return GPG_FULL;
+        case SEAHORSE_VALIDITY_ULTIMATE:
+            return GPG_ULTIMATE;
+        default:
+            return 1;
+    }
+}
+
+void
+seahorse_gpgme_key_op_set_trust_async (SeahorseGpgmeKey *pkey,
+                                       SeahorseValidity trust,
+                                       GCancellable *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data)
 {
-	gchar *command;
 	SeahorseEditParm *parms;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	/* Get command and op */
-	if (disabled)
-		command = "disable";
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (trust >= SEAHORSE_VALIDITY_NEVER);
+	g_return_if_fail (seahorse_gpgme_key_get_trust (pkey) != trust);
+
+	if (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY)
+		g_return_if_fail (trust != SEAHORSE_VALIDITY_UNKNOWN);
 	else
-		command = "enable";
-	
-	parms = seahorse_edit_parm_new (DISABLE_START, edit_disable_action, edit_disable_transit, command);
-	
-	return edit_key (pkey, parms);
+		g_return_if_fail (trust != SEAHORSE_VALIDITY_ULTIMATE);
+
+	parms = seahorse_edit_parm_new (TRUST_START, edit_trust_action, edit_trust_transit,
+	                                GINT_TO_POINTER (trust_menu_choice (trust)));
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_set_trust_async,
+	                                       parms, NULL, cancellable, callback, user_data));
+}
+
+gboolean
+seahorse_gpgme_key_op_set_trust_finish (SeahorseGpgmeKey *pkey,
+                                        GAsyncResult *result,
+                                        GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_set_trust_async, error);
 }
 
 typedef struct
@@ -1168,25 +1381,35 @@ edit_expire_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_set_expires (SeahorseGpgmeSubkey *subkey, const time_t expires)
+void
+seahorse_gpgme_key_op_set_expires_async (SeahorseGpgmeSubkey *subkey,
+                                         time_t expires,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
 {
-	ExpireParm exp_parm;
 	SeahorseEditParm *parms;
-	gpgme_key_t key;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (expires != (time_t)seahorse_pgp_subkey_get_expires (SEAHORSE_PGP_SUBKEY (subkey)), GPG_E (GPG_ERR_INV_VALUE));
-	
-	key = seahorse_gpgme_subkey_get_pubkey (subkey);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-	
-	exp_parm.index = seahorse_pgp_subkey_get_index (SEAHORSE_PGP_SUBKEY (subkey)); 
-	exp_parm.expires = expires;
-	
-	parms = seahorse_edit_parm_new (EXPIRE_START, edit_expire_action, edit_expire_transit, &exp_parm);
-	
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	ExpireParm *exp_parm;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey));
+	g_return_if_fail (expires != (time_t)seahorse_pgp_subkey_get_expires (SEAHORSE_PGP_SUBKEY (subkey)));
+
+	exp_parm = g_new0 (ExpireParm, 1);
+	exp_parm->index = seahorse_pgp_subkey_get_index (SEAHORSE_PGP_SUBKEY (subkey));
+	exp_parm->expires = expires;
+
+	parms = seahorse_edit_parm_new (EXPIRE_START, edit_expire_action, edit_expire_transit, exp_parm);
+	edit_gpgme_key_start (edit_result_new (subkey, seahorse_gpgme_key_op_set_expires_async,
+	                                       parms, g_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_subkey_get_pubkey (subkey));
+}
+
+gboolean
+seahorse_gpgme_key_op_set_expires_finish (SeahorseGpgmeSubkey *subkey,
+                                          GAsyncResult *result,
+                                          GError **error)
+{
+	return edit_key_finish (subkey, result, seahorse_gpgme_key_op_set_expires_async, error);
 }
 
 typedef enum {
@@ -1295,24 +1518,36 @@ add_revoker_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_add_revoker (SeahorseGpgmeKey *pkey, SeahorseGpgmeKey *revoker)
+void
+seahorse_gpgme_key_op_add_revoker_async (SeahorseGpgmeKey *pkey,
+                                         SeahorseGpgmeKey *revoker,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
 {
 	SeahorseEditParm *parms;
 	const gchar *keyid;
 
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));    
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (revoker), GPG_E (GPG_ERR_WRONG_KEY_USAGE));    
-	g_return_val_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (revoker)) == SEAHORSE_USAGE_PRIVATE_KEY, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (revoker));
+	g_return_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY);
+	g_return_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (revoker)) == SEAHORSE_USAGE_PRIVATE_KEY);
 
 	keyid = seahorse_pgp_key_get_keyid (SEAHORSE_PGP_KEY (pkey));
-	g_return_val_if_fail (keyid, GPG_E (GPG_ERR_INV_VALUE));
+	g_return_if_fail (keyid);
 
 	parms = seahorse_edit_parm_new (ADD_REVOKER_START, add_revoker_action,
-	                                add_revoker_transit, (gpointer)keyid);
+	                                add_revoker_transit, g_strdup (keyid));
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_add_revoker_async,
+	                                       parms, g_free, cancellable, callback, user_data));
+}
 
-	return edit_key (pkey, parms);
+gboolean
+seahorse_gpgme_key_op_add_revoker_finish (SeahorseGpgmeKey *pkey,
+                                          GAsyncResult *result,
+                                          GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_add_revoker_async, error);
 }
 
 typedef enum {
@@ -1439,25 +1674,48 @@ add_uid_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_add_uid (SeahorseGpgmeKey *pkey, const gchar *name, 
-                               const gchar *email, const gchar *comment)
+static void
+uid_parm_free (gpointer data)
+{
+	UidParm *uid_parm = data;
+	g_free ((gchar *)uid_parm->name);
+	g_free ((gchar *)uid_parm->email);
+	g_free ((gchar *)uid_parm->comment);
+	g_free (uid_parm);
+}
+
+void
+seahorse_gpgme_key_op_add_uid_async (SeahorseGpgmeKey *pkey,
+                                     const gchar *name,
+                                     const gchar *email,
+                                     const gchar *comment,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
 {
 	SeahorseEditParm *parms;
 	UidParm *uid_parm;
-	
-    g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));    
-    g_return_val_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (name != NULL && strlen (name) >= 5, GPG_E (GPG_ERR_INV_VALUE));
-	
-	uid_parm = g_new (UidParm, 1);
-	uid_parm->name = name;
-	uid_parm->email = email;
-	uid_parm->comment = comment;
-	
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY);
+	g_return_if_fail (name != NULL && strlen (name) >= 5);
+
+	uid_parm = g_new0 (UidParm, 1);
+	uid_parm->name = g_strdup (name);
+	uid_parm->email = g_strdup (email);
+	uid_parm->comment = g_strdup (comment);
+
 	parms = seahorse_edit_parm_new (ADD_UID_START, add_uid_action, add_uid_transit, uid_parm);
-	
-	return edit_key (pkey, parms);
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_add_uid_async,
+	                                       parms, uid_parm_free, cancellable, callback, user_data));
+}
+
+gboolean
+seahorse_gpgme_key_op_add_uid_finish (SeahorseGpgmeKey *pkey,
+                                      GAsyncResult *result,
+                                      GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_add_uid_async, error);
 }
 
 typedef enum {
@@ -1572,52 +1830,78 @@ add_key_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_add_subkey (SeahorseGpgmeKey *pkey, const SeahorseKeyEncType type, 
-                                  const guint length, const time_t expires)
+/* Checks the length for @type, and looks up the gpg menu choice for it */
+static gpgme_error_t
+subkey_real_type (SeahorseKeyEncType type,
+                  guint length,
+                  guint *real_type)
 {
-	SeahorseEditParm *parms;
-	SubkeyParm *key_parm;
-	guint real_type;
 	SeahorseKeyTypeTable table;
 	gpgme_error_t gerr;
-	
-    g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));    
-    g_return_val_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY, GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
+
 	gerr = seahorse_gpgme_get_keytype_table (&table);
 	g_return_val_if_fail (GPG_IS_OK (gerr), gerr);
 	
 	/* Check length range & type */
 	switch (type) {
 		case DSA:
-			real_type = table->dsa_sign;
+			*real_type = table->dsa_sign;
 			g_return_val_if_fail (length >= DSA_MIN && length <= DSA_MAX, GPG_E (GPG_ERR_INV_VALUE));
 			break;
 		case ELGAMAL:
-			real_type = table->elgamal_enc;
+			*real_type = table->elgamal_enc;
 			g_return_val_if_fail (length >= ELGAMAL_MIN && length <= LENGTH_MAX, GPG_E (GPG_ERR_INV_VALUE));
 			break;
 		case RSA_SIGN: case RSA_ENCRYPT:
 			if (type == RSA_SIGN)
-				real_type = table->rsa_sign;
+				*real_type = table->rsa_sign;
 			else
-				real_type = table->rsa_enc;
+				*real_type = table->rsa_enc;
 			g_return_val_if_fail (length >= RSA_MIN && length <= LENGTH_MAX, GPG_E (GPG_ERR_INV_VALUE));
 			break;
 		default:
 			g_return_val_if_reached (GPG_E (GPG_ERR_INV_VALUE));
 			break;
 	}
-	
-	key_parm = g_new (SubkeyParm, 1);
+
+	return GPG_OK;
+}
+
+void
+seahorse_gpgme_key_op_add_subkey_async (SeahorseGpgmeKey *pkey,
+                                        SeahorseKeyEncType type,
+                                        guint length,
+                                        time_t expires,
+                                        GCancellable *cancellable,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+	SeahorseEditParm *parms;
+	SubkeyParm *key_parm;
+	guint real_type;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (seahorse_object_get_usage (SEAHORSE_OBJECT (pkey)) == SEAHORSE_USAGE_PRIVATE_KEY);
+
+	if (!GPG_IS_OK (subkey_real_type (type, length, &real_type)))
+		return;
+
+	key_parm = g_new0 (SubkeyParm, 1);
 	key_parm->type = real_type;
 	key_parm->length = length;
 	key_parm->expires = expires;
-	
+
 	parms = seahorse_edit_parm_new (ADD_KEY_START, add_key_action, add_key_transit, key_parm);
-	
-	return edit_key (pkey, parms);
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_add_subkey_async,
+	                                       parms, g_free, cancellable, callback, user_data));
+}
+
+gboolean
+seahorse_gpgme_key_op_add_subkey_finish (SeahorseGpgmeKey *pkey,
+                                         GAsyncResult *result,
+                                         GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_add_subkey_async, error);
 }
 
 typedef enum {
@@ -1723,23 +2007,31 @@ del_key_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_del_subkey (SeahorseGpgmeSubkey *subkey)
+void
+seahorse_gpgme_key_op_del_subkey_async (SeahorseGpgmeSubkey *subkey,
+                                        GCancellable *cancellable,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
 {
 	SeahorseEditParm *parms;
-	gpgme_key_t key;
-	int index;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	key = seahorse_gpgme_subkey_get_pubkey (subkey);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-	
+	guint index;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey));
+
 	index = seahorse_pgp_subkey_get_index (SEAHORSE_PGP_SUBKEY (subkey));
 	parms = seahorse_edit_parm_new (DEL_KEY_START, del_key_action,
 	                                del_key_transit, GUINT_TO_POINTER (index));
-	
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	edit_gpgme_key_start (edit_result_new (subkey, seahorse_gpgme_key_op_del_subkey_async,
+	                                       parms, NULL, cancellable, callback, user_data),
+	                      seahorse_gpgme_subkey_get_pubkey (subkey));
+}
+
+gboolean
+seahorse_gpgme_key_op_del_subkey_finish (SeahorseGpgmeSubkey *subkey,
+                                         GAsyncResult *result,
+                                         GError **error)
+{
+	return edit_key_finish (subkey, result, seahorse_gpgme_key_op_del_subkey_async, error);
 }
 
 typedef struct
@@ -1899,31 +2191,49 @@ rev_subkey_transit (guint current_state, gpgme_status_code_t status,
 	return next_state;
 }
 
-gpgme_error_t
-seahorse_gpgme_key_op_revoke_subkey (SeahorseGpgmeSubkey *subkey, SeahorseRevokeReason reason, 
-                                     const gchar *description)
+static void
+rev_subkey_parm_free (gpointer data)
+{
+	RevSubkeyParm *rev_parm = data;
+	g_free ((gchar *)rev_parm->description);
+	g_free (rev_parm);
+}
+
+void
+seahorse_gpgme_key_op_revoke_subkey_async (SeahorseGpgmeSubkey *subkey,
+                                           SeahorseRevokeReason reason,
+                                           const gchar *description,
+                                           GCancellable *cancellable,
+                                           GAsyncReadyCallback callback,
+                                           gpointer user_data)
 {
-	RevSubkeyParm rev_parm;
 	SeahorseEditParm *parms;
+	RevSubkeyParm *rev_parm;
 	gpgme_subkey_t gsubkey;
-	gpgme_key_t key;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey));
+
 	gsubkey = seahorse_gpgme_subkey_get_subkey (subkey);
-	g_return_val_if_fail (!gsubkey->revoked, GPG_E (GPG_ERR_INV_VALUE));
-	
-	key = seahorse_gpgme_subkey_get_pubkey (subkey);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-	
-	rev_parm.index = seahorse_pgp_subkey_get_index (SEAHORSE_PGP_SUBKEY (subkey));
-	rev_parm.reason = reason;
-	rev_parm.description = description;
-	
+	g_return_if_fail (!gsubkey->revoked);
+
+	rev_parm = g_new0 (RevSubkeyParm, 1);
+	rev_parm->index = seahorse_pgp_subkey_get_index (SEAHORSE_PGP_SUBKEY (subkey));
+	rev_parm->reason = reason;
+	rev_parm->description = g_strdup (description);
+
 	parms = seahorse_edit_parm_new (REV_SUBKEY_START, rev_subkey_action,
-	                                rev_subkey_transit, &rev_parm);
-	
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	                                rev_subkey_transit, rev_parm);
+	edit_gpgme_key_start (edit_result_new (subkey, seahorse_gpgme_key_op_revoke_subkey_async,
+	                                       parms, rev_subkey_parm_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_subkey_get_pubkey (subkey));
+}
+
+gboolean
+seahorse_gpgme_key_op_revoke_subkey_finish (SeahorseGpgmeSubkey *subkey,
+                                            GAsyncResult *result,
+                                            GError **error)
+{
+	return edit_key_finish (subkey, result, seahorse_gpgme_key_op_revoke_subkey_async, error);
 }
 
 typedef struct {
@@ -2034,30 +2344,38 @@ primary_transit (guint current_state, gpgme_status_code_t status,
     return next_state;
 }
                 
-gpgme_error_t   
-seahorse_gpgme_key_op_primary_uid (SeahorseGpgmeUid *uid)
+void
+seahorse_gpgme_key_op_primary_uid_async (SeahorseGpgmeUid *uid,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
 {
-	PrimaryParm pri_parm;
 	SeahorseEditParm *parms;
+	PrimaryParm *pri_parm;
 	gpgme_user_id_t userid;
-	gpgme_key_t key;
 
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_UID (uid), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-    
+	g_return_if_fail (SEAHORSE_IS_GPGME_UID (uid));
+
 	/* Make sure not revoked */
 	userid = seahorse_gpgme_uid_get_userid (uid);
-	g_return_val_if_fail (userid != NULL && !userid->revoked && !userid->invalid, 
-	                      GPG_E (GPG_ERR_INV_VALUE));
-    
-	key = seahorse_gpgme_uid_get_pubkey (uid);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-    
-	pri_parm.index = seahorse_gpgme_uid_get_actual_index (uid);
-   
+	g_return_if_fail (userid != NULL && !userid->revoked && !userid->invalid);
+
+	pri_parm = g_new0 (PrimaryParm, 1);
+	pri_parm->index = seahorse_gpgme_uid_get_actual_index (uid);
+
 	parms = seahorse_edit_parm_new (PRIMARY_START, primary_action,
-	                                primary_transit, &pri_parm);
- 
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	                                primary_transit, pri_parm);
+	edit_gpgme_key_start (edit_result_new (uid, seahorse_gpgme_key_op_primary_uid_async,
+	                                       parms, g_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_uid_get_pubkey (uid));
+}
+
+gboolean
+seahorse_gpgme_key_op_primary_uid_finish (SeahorseGpgmeUid *uid,
+                                          GAsyncResult *result,
+                                          GError **error)
+{
+	return edit_key_finish (uid, result, seahorse_gpgme_key_op_primary_uid_async, error);
 }
 
 
@@ -2184,24 +2502,33 @@ del_uid_transit (guint current_state, gpgme_status_code_t status,
     return next_state;
 }
                 
-gpgme_error_t   
-seahorse_gpgme_key_op_del_uid (SeahorseGpgmeUid *uid)
+void
+seahorse_gpgme_key_op_del_uid_async (SeahorseGpgmeUid *uid,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
 {
-	DelUidParm del_uid_parm;
 	SeahorseEditParm *parms;
-	gpgme_key_t key;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_UID (uid), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-    
-	key = seahorse_gpgme_uid_get_pubkey (uid);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-  
-	del_uid_parm.index = seahorse_gpgme_uid_get_actual_index (uid);
-	
+	DelUidParm *del_uid_parm;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_UID (uid));
+
+	del_uid_parm = g_new0 (DelUidParm, 1);
+	del_uid_parm->index = seahorse_gpgme_uid_get_actual_index (uid);
+
 	parms = seahorse_edit_parm_new (DEL_UID_START, del_uid_action,
-	                                del_uid_transit, &del_uid_parm);
- 
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	                                del_uid_transit, del_uid_parm);
+	edit_gpgme_key_start (edit_result_new (uid, seahorse_gpgme_key_op_del_uid_async,
+	                                       parms, g_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_uid_get_pubkey (uid));
+}
+
+gboolean
+seahorse_gpgme_key_op_del_uid_finish (SeahorseGpgmeUid *uid,
+                                      GAsyncResult *result,
+                                      GError **error)
+{
+	return edit_key_finish (uid, result, seahorse_gpgme_key_op_del_uid_async, error);
 }
 
 typedef struct {
@@ -2312,289 +2639,98 @@ photoid_add_transit (guint current_state, gpgme_status_code_t status,
     return next_state;
 }
 
-gpgme_error_t 
-seahorse_gpgme_key_op_photo_add (SeahorseGpgmeKey *pkey, const gchar *filename)
+static void
+photoid_add_parm_free (gpointer data)
 {
-	SeahorseEditParm *parms;
-	PhotoIdAddParm photoid_add_parm;
-	gpgme_key_t key;
-	
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	g_return_val_if_fail (filename, GPG_E (GPG_ERR_INV_VALUE));
-      
-	key = seahorse_gpgme_key_get_public (pkey);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-    
-	photoid_add_parm.filename = filename;
-	
-	parms = seahorse_edit_parm_new (PHOTO_ID_ADD_START, photoid_add_action,
-	                                photoid_add_transit, &photoid_add_parm);
-	
-	return edit_refresh_gpgme_key (NULL, key, parms);
+	PhotoIdAddParm *photoid_add_parm = data;
+	g_free ((gchar *)photoid_add_parm->filename);
+	g_free (photoid_add_parm);
 }
 
-gpgme_error_t 
-seahorse_gpgme_key_op_photo_delete (SeahorseGpgmePhoto *photo)
+void
+seahorse_gpgme_key_op_photo_add_async (SeahorseGpgmeKey *pkey,
+                                       const gchar *filename,
+                                       GCancellable *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data)
 {
-	DelUidParm del_uid_parm;
 	SeahorseEditParm *parms;
-	gpgme_key_t key;
- 
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-      
-	key = seahorse_gpgme_photo_get_pubkey (photo);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-    
-	del_uid_parm.index = seahorse_gpgme_photo_get_index (photo);
-   
-	parms = seahorse_edit_parm_new (DEL_UID_START, del_uid_action,
-	                                del_uid_transit, &del_uid_parm);
- 
-	return edit_refresh_gpgme_key (NULL, key, parms);
-}
+	PhotoIdAddParm *photoid_add_parm;
 
-typedef struct {
-	GList *photos;
-	guint uid;
-	guint num_uids;
-	char *output_file;
-	gpgme_key_t key;
-} PhotoIdLoadParm;
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (pkey));
+	g_return_if_fail (filename);
 
-typedef enum {
-    PHOTO_ID_LOAD_START,
-    PHOTO_ID_LOAD_SELECT,
-    PHOTO_ID_LOAD_OUTPUT_IMAGE,
-    PHOTO_ID_LOAD_DESELECT,
-    PHOTO_ID_LOAD_QUIT,
-    PHOTO_ID_LOAD_ERROR
-} PhotoIdLoadState;
-
-/* action helper for getting a list of photoids attached to a #SeahorseKey */
-static gpgme_error_t
-photoid_load_action (guint state, gpointer data, int fd)
-{
-    PhotoIdLoadParm *parm = (PhotoIdLoadParm*)data;
-    
-    switch (state) {
-	    case PHOTO_ID_LOAD_SELECT:
-            PRINTF ((fd, "uid %d", parm->uid));            
-	        break;
-	    case PHOTO_ID_LOAD_OUTPUT_IMAGE:
-            PRINT ((fd, "showphoto"));
-	        break;
-	    case PHOTO_ID_LOAD_DESELECT:
-	        PRINTF ((fd, "uid %d", parm->uid));            
-	        break;
-	    case PHOTO_ID_LOAD_QUIT:
-            PRINT ((fd, QUIT));
-	        break;
-	    default:
-	        g_return_val_if_reached (GPG_E (GPG_ERR_GENERAL));
-	        break;
-    }
-  
-    seahorse_util_print_fd (fd, "\n");
-    return GPG_OK;
+	photoid_add_parm = g_new0 (PhotoIdAddParm, 1);
+	photoid_add_parm->filename = g_strdup (filename);
+
+	parms = seahorse_edit_parm_new (PHOTO_ID_ADD_START, photoid_add_action,
+	                                photoid_add_transit, photoid_add_parm);
+	edit_key_start (pkey, edit_result_new (pkey, seahorse_gpgme_key_op_photo_add_async,
+	                                       parms, photoid_add_parm_free, cancellable, callback, user_data));
 }
 
-static guint
-photoid_load_transit (guint current_state, gpgme_status_code_t status,
-                      const gchar *args, gpointer data, gpgme_error_t *err)
-{
-	PhotoIdLoadParm *parm = (PhotoIdLoadParm*)data;
-	SeahorseGpgmePhoto *photo;
-	GdkPixbuf *pixbuf = NULL;
-	guint next_state = 0;
-	struct stat st;
-	GError *error = NULL;
-	
-	switch (current_state) {
-    
-	/* start, get photoid list */
-	case PHOTO_ID_LOAD_START:
-		if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT))
-			next_state = PHOTO_ID_LOAD_SELECT;
-		else {
-			*err = GPG_E (GPG_ERR_GENERAL);
-			g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-		}
-		break;
-		
-	case PHOTO_ID_LOAD_SELECT:
-		if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT)) {
-			next_state = PHOTO_ID_LOAD_OUTPUT_IMAGE;
-		} else {
-			*err = GPG_E (GPG_ERR_GENERAL);
-			g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-		}
-		break;
-		
-	case PHOTO_ID_LOAD_OUTPUT_IMAGE:
-		
-		if (g_file_test (parm->output_file, G_FILE_TEST_EXISTS)) {
-
-			photo = seahorse_gpgme_photo_new (parm->key, NULL, parm->uid);
-			parm->photos = g_list_append (parm->photos, photo);
-			
-			if (g_stat (parm->output_file, &st) == -1) {
-				g_warning ("couldn't stat output image file '%s': %s", parm->output_file,
-				           g_strerror (errno));
-			    
-			} else if (st.st_size > 0) {
-				pixbuf = gdk_pixbuf_new_from_file (parm->output_file, &error);
-				if (pixbuf == NULL) {
-					g_warning ("Loading image %s failed: %s", parm->output_file,
-					           error && error->message ? error->message : "unknown");
-					g_error_free (error);
-				} 
-			}
-			
-			g_unlink (parm->output_file);
-			
-			/* Load a 'missing' icon */
-			if (!pixbuf) {
-				pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (), 
-				                                   "gnome-unknown", 48, 0, NULL);
-			}
-			    
-			seahorse_pgp_photo_set_pixbuf (SEAHORSE_PGP_PHOTO (photo), pixbuf);
-			g_object_unref (pixbuf);
-		}
-	
-		if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT)) {
-			next_state = PHOTO_ID_LOAD_DESELECT;
-		} else {
-			*err = GPG_E (GPG_ERR_GENERAL);
-			g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-		}
-		break;
-		
-	case PHOTO_ID_LOAD_DESELECT:
-		if (parm->uid < parm->num_uids) {
-			parm->uid = parm->uid + 1;
-			g_debug ("PhotoIDLoad Next UID %i", parm->uid);
-			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT)) {
-				next_state = PHOTO_ID_LOAD_SELECT;
-			} else {
-				*err = GPG_E (GPG_ERR_GENERAL);
-				g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-			}
-		} else {
-			if (status == GPGME_STATUS_GET_LINE && g_str_equal (args, PROMPT)) {
-				next_state = PHOTO_ID_LOAD_QUIT;
-				g_debug ("PhotoIDLoad Quiting Load");
-			} else {
-				*err = GPG_E (GPG_ERR_GENERAL);
-				g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-			}
-		}
-		break;
-		
-	case PHOTO_ID_LOAD_QUIT:
-		/* Shouldn't be reached */
-		*err = GPG_E (GPG_ERR_GENERAL);
-		g_debug ("PhotoIDLoad Reached Quit");
-		g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-		break;
-		
-	default:
-		*err = GPG_E (GPG_ERR_GENERAL);
-		g_return_val_if_reached (PHOTO_ID_LOAD_ERROR);
-		break;
-	}
-    
-	return next_state;
+gboolean
+seahorse_gpgme_key_op_photo_add_finish (SeahorseGpgmeKey *pkey,
+                                        GAsyncResult *result,
+                                        GError **error)
+{
+	return edit_key_finish (pkey, result, seahorse_gpgme_key_op_photo_add_async, error);
 }
 
-gpgme_error_t 
-seahorse_gpgme_key_op_photos_load (SeahorseGpgmeKey *pkey)
+void
+seahorse_gpgme_key_op_photo_delete_async (SeahorseGpgmePhoto *photo,
+                                          GCancellable *cancellable,
+                                          GAsyncReadyCallback callback,
+                                          gpointer user_data)
 {
-	/* Make sure there's enough room for the .jpg extension */
-	gchar image_path[]    = "/tmp/seahorse-photoid-XXXXXX\0\0\0\0";
-    
 	SeahorseEditParm *parms;
-	PhotoIdLoadParm photoid_load_parm;
-	gpgme_error_t gerr;
-	gpgme_key_t key;
-	const gchar *oldpath;
-	const gchar *keyid;
-	gchar *path;
-	gint fd;
-
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-	
-	key = seahorse_gpgme_key_get_public (pkey);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-	g_return_val_if_fail (key->subkeys && key->subkeys->keyid, GPG_E (GPG_ERR_INV_VALUE));
-	keyid = key->subkeys->keyid;
-
-	g_debug ("PhotoIDLoad Start");
+	DelUidParm *del_uid_parm;
 
-	fd = g_mkstemp (image_path);
-	if(fd == -1) { 
-		gerr = GPG_E(GPG_ERR_GENERAL);
-    
-	} else {
+	g_return_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo));
 
-		g_unlink(image_path);
-		close(fd);
-		strcat (image_path, ".jpg");
-        
-		photoid_load_parm.uid = 1;
-		photoid_load_parm.num_uids = 0;
-		photoid_load_parm.photos = NULL;
-		photoid_load_parm.output_file = image_path;
-		photoid_load_parm.key = key;
-
-		g_debug ("PhotoIdLoad KeyID %s", keyid);
-		gerr = seahorse_gpg_op_num_uids (NULL, keyid, &(photoid_load_parm.num_uids));
-		g_debug ("PhotoIDLoad Number of UIDs %i", photoid_load_parm.num_uids);
-
-		if (GPG_IS_OK (gerr)) {
-            
-			setenv ("SEAHORSE_IMAGE_FILE", image_path, 1);
-			oldpath = getenv("PATH");
-            
-			path = g_strdup_printf ("%s:%s", EXECDIR, getenv ("PATH"));
-			setenv ("PATH", path, 1);
-			g_free (path);
-            
-			parms = seahorse_edit_parm_new (PHOTO_ID_LOAD_START, photoid_load_action,
-			                                photoid_load_transit, &photoid_load_parm);
-            
-			/* generate list */
-			gerr = edit_gpgme_key (NULL, key, parms);
-			setenv ("PATH", oldpath, 1);
-
-			if (GPG_IS_OK (gerr))
-				seahorse_pgp_key_set_photos (SEAHORSE_PGP_KEY (pkey), photoid_load_parm.photos);
-		}
-		
-		seahorse_object_list_free (photoid_load_parm.photos);
-	}
+	del_uid_parm = g_new0 (DelUidParm, 1);
+	del_uid_parm->index = seahorse_gpgme_photo_get_index (photo);
 
-	g_debug ("PhotoIDLoad Done");
+	parms = seahorse_edit_parm_new (DEL_UID_START, del_uid_action,
+	                                del_uid_transit, del_uid_parm);
+	edit_gpgme_key_start (edit_result_new (photo, seahorse_gpgme_key_op_photo_delete_async,
+	                                       parms, g_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_photo_get_pubkey (photo));
+}
 
-	return gerr;
+gboolean
+seahorse_gpgme_key_op_photo_delete_finish (SeahorseGpgmePhoto *photo,
+                                           GAsyncResult *result,
+                                           GError **error)
+{
+	return edit_key_finish (photo, result, seahorse_gpgme_key_op_photo_delete_async, error);
 }
 
-gpgme_error_t   
-seahorse_gpgme_key_op_photo_primary (SeahorseGpgmePhoto *photo)
+void
+seahorse_gpgme_key_op_photo_primary_async (SeahorseGpgmePhoto *photo,
+                                           GCancellable *cancellable,
+                                           GAsyncReadyCallback callback,
+                                           gpointer user_data)
 {
-	PrimaryParm pri_parm;
 	SeahorseEditParm *parms;
-	gpgme_key_t key;
-    
-	g_return_val_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo), GPG_E (GPG_ERR_WRONG_KEY_USAGE));
-      
-	key = seahorse_gpgme_photo_get_pubkey (photo);
-	g_return_val_if_fail (key, GPG_E (GPG_ERR_INV_VALUE));
-    
-	pri_parm.index = seahorse_gpgme_photo_get_index (photo);
-   
+	PrimaryParm *pri_parm;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo));
+
+	pri_parm = g_new0 (PrimaryParm, 1);
+	pri_parm->index = seahorse_gpgme_photo_get_index (photo);
+
 	parms = seahorse_edit_parm_new (PRIMARY_START, primary_action,
-	                                primary_transit, &pri_parm);
+	                                primary_transit, pri_parm);
+	edit_gpgme_key_start (edit_result_new (photo, seahorse_gpgme_key_op_photo_primary_async,
+	                                       parms, g_free, cancellable, callback, user_data),
+	                      seahorse_gpgme_photo_get_pubkey (photo));
+}
 
-	return edit_refresh_gpgme_key (NULL, key, parms);
+gboolean
+seahorse_gpgme_key_op_photo_primary_finish (SeahorseGpgmePhoto *photo,
+                                            GAsyncResult *result,
+                                            GError **error)
+{
+	return edit_key_finish (photo, result, seahorse_gpgme_key_op_photo_primary_async, error);
 }
@@ -118,57 +118,145 @@ gpgme_error_t         seahorse_gpgme_key_op_delete           (SeahorseGpgmeKey *
 
 gpgme_error_t         seahorse_gpgme_key_op_delete_pair      (SeahorseGpgmeKey *pkey);
 
-gpgme_error_t         seahorse_gpgme_key_op_sign             (SeahorseGpgmeKey *key,
+void                  seahorse_gpgme_key_op_sign_multiple_async (GList *objects,
                                                               SeahorseGpgmeKey *signer,
                                                               SeahorseSignCheck check,
-                                                              SeahorseSignOptions options);
+                                                              SeahorseSignOptions options,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_sign_uid         (SeahorseGpgmeUid *uid, 
-                                                              SeahorseGpgmeKey *signer, 
-                                                              SeahorseSignCheck check, 
-                                                              SeahorseSignOptions options);
+gboolean              seahorse_gpgme_key_op_sign_multiple_finish (SeahorseGpgmeKey *signer,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_change_pass      (SeahorseGpgmeKey *pkey);
+void                  seahorse_gpgme_key_op_change_pass_async (SeahorseGpgmeKey *pkey,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_change_pass_finish (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_set_trust        (SeahorseGpgmeKey *pkey,
-                                                              SeahorseValidity validity);
+void                  seahorse_gpgme_key_op_set_trust_async  (SeahorseGpgmeKey *pkey,
+                                                              SeahorseValidity validity,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_set_disabled     (SeahorseGpgmeKey *pkey,
-                                                              gboolean disabled);
+gboolean              seahorse_gpgme_key_op_set_trust_finish (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_set_expires      (SeahorseGpgmeSubkey *subkey,
-                                                              time_t expires);
+void                  seahorse_gpgme_key_op_set_expires_async (SeahorseGpgmeSubkey *subkey,
+                                                              time_t expires,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_add_revoker      (SeahorseGpgmeKey *pkey, 
-                                                              SeahorseGpgmeKey *revoker);
+gboolean              seahorse_gpgme_key_op_set_expires_finish (SeahorseGpgmeSubkey *subkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_add_uid          (SeahorseGpgmeKey *pkey,
+void                  seahorse_gpgme_key_op_add_revoker_async (SeahorseGpgmeKey *pkey,
+                                                              SeahorseGpgmeKey *revoker,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_add_revoker_finish (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
+
+void                  seahorse_gpgme_key_op_add_uid_async    (SeahorseGpgmeKey *pkey,
                                                               const gchar *name,
                                                               const gchar *email,
-                                                              const gchar *comment);
+                                                              const gchar *comment,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_add_uid_finish   (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
+
+void                  seahorse_gpgme_key_op_primary_uid_async (SeahorseGpgmeUid *uid,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_primary_uid_finish (SeahorseGpgmeUid *uid,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_primary_uid      (SeahorseGpgmeUid *uid);
+void                  seahorse_gpgme_key_op_del_uid_async    (SeahorseGpgmeUid *uid,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_del_uid          (SeahorseGpgmeUid *uid);
+gboolean              seahorse_gpgme_key_op_del_uid_finish   (SeahorseGpgmeUid *uid,
+                                                              GAsyncResult *result,
+                                                              GError **error);
                              
-gpgme_error_t         seahorse_gpgme_key_op_add_subkey       (SeahorseGpgmeKey *pkey,
+void                  seahorse_gpgme_key_op_add_subkey_async (SeahorseGpgmeKey *pkey,
                                                               SeahorseKeyEncType type,
                                                               guint length,
-                                                              time_t expires);
+                                                              time_t expires,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_del_subkey       (SeahorseGpgmeSubkey *subkey);
+gboolean              seahorse_gpgme_key_op_add_subkey_finish (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
+
+void                  seahorse_gpgme_key_op_del_subkey_async (SeahorseGpgmeSubkey *subkey,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_revoke_subkey    (SeahorseGpgmeSubkey *subkey,
+gboolean              seahorse_gpgme_key_op_del_subkey_finish (SeahorseGpgmeSubkey *subkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
+
+void                  seahorse_gpgme_key_op_revoke_subkey_async (SeahorseGpgmeSubkey *subkey,
                                                               SeahorseRevokeReason reason,
-                                                              const gchar *description);
+                                                              const gchar *description,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_revoke_subkey_finish (SeahorseGpgmeSubkey *subkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
-gpgme_error_t         seahorse_gpgme_key_op_photo_add        (SeahorseGpgmeKey *pkey,
-                                                              const gchar *filename);
+void                  seahorse_gpgme_key_op_photo_add_async  (SeahorseGpgmeKey *pkey,
+                                                              const gchar *filename,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_photo_add_finish (SeahorseGpgmeKey *pkey,
+                                                              GAsyncResult *result,
+                                                              GError **error);
  
-gpgme_error_t         seahorse_gpgme_key_op_photo_delete     (SeahorseGpgmePhoto *photo);
+void                  seahorse_gpgme_key_op_photo_delete_async (SeahorseGpgmePhoto *photo,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
+
+gboolean              seahorse_gpgme_key_op_photo_delete_finish (SeahorseGpgmePhoto *photo,
+                                                              GAsyncResult *result,
+                                                              GError **error);
                                                      
-gpgme_error_t         seahorse_gpgme_key_op_photos_load      (SeahorseGpgmeKey *key);
+void                  seahorse_gpgme_key_op_photo_primary_async (SeahorseGpgmePhoto *photo,
+                                                              GCancellable *cancellable,
+                                                              GAsyncReadyCallback callback,
+                                                              gpointer user_data);
 
-gpgme_error_t         seahorse_gpgme_key_op_photo_primary    (SeahorseGpgmePhoto *photo);
+gboolean              seahorse_gpgme_key_op_photo_primary_finish (SeahorseGpgmePhoto *photo,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
 #endif /* __SEAHORSE_GPGME_KEY_OP_H__ */
@@ -24,12 +24,15 @@
 #include "seahorse-gpgme-key-op.h"
 #include "seahorse-gpgme-key-deleter.h"
 #include "seahorse-gpgme-photo.h"
+#include "seahorse-gpgme-photo-loader.h"
 #include "seahorse-gpgme-keyring.h"
 #include "seahorse-gpgme-secret-deleter.h"
 #include "seahorse-gpgme-uid.h"
 #include "seahorse-pgp-actions.h"
 #include "seahorse-pgp-backend.h"
 #include "seahorse-pgp-key.h"
+#include "seahorse-pgp-subkey.h"
+#include "seahorse-pgp-uid.h"
 
 #include "seahorse-common.h"
 
@@ -67,8 +70,15 @@ struct _SeahorseGpgmeKeyPrivate {
 
 	int list_mode;                  /* What to load our public key as */
 	gboolean photos_loaded;		/* Photos were loaded */
+	gboolean photos_loading;	/* Photos are being loaded in the background */
 	
 	gint block_loading;        	/* Loading is blocked while this flag is set */
+
+	gboolean cached;		/* Populated from the key cache, not yet listed */
+	SeahorseValidity cached_validity;
+	SeahorseValidity cached_trust;
+
+	gboolean subkeys_realized;	/* Subkeys are up to date with pubkey */
 };
 
 /* -----------------------------------------------------------------------------
@@ -85,7 +95,7 @@ load_gpgme_key (const gchar *keyid,
 	gpgme_ctx_t ctx;
 	gpgme_error_t gerr;
 
-	ctx = seahorse_gpgme_keyring_new_context (&gerr);
+	ctx = seahorse_gpgme_keyring_acquire_context (&gerr);
 	if (gerr != 0)
 		return FALSE;
 
@@ -96,7 +106,7 @@ load_gpgme_key (const gchar *keyid,
 		gpgme_op_keylist_end (ctx);
 	}
 
-	gpgme_release (ctx);
+	seahorse_gpgme_keyring_release_context (ctx);
 
 	if (seahorse_gpgme_propagate_error (gerr, &error)) {
 		g_message ("couldn't load GPGME key: %s", error->message);
@@ -162,31 +172,68 @@ require_key_private (SeahorseGpgmeKey *self)
 	return self->pv->seckey != NULL;
 }
 
+/* Keys from the key cache answer from it until the keyring lists them */
+static gboolean
+is_key_cached (SeahorseGpgmeKey *self)
+{
+	return self->pv->cached && !self->pv->pubkey;
+}
+
 static gboolean
 require_key_uids (SeahorseGpgmeKey *self)
 {
-	return require_key_public (self, GPGME_KEYLIST_MODE_LOCAL);
+	return is_key_cached (self) ||
+	       require_key_public (self, GPGME_KEYLIST_MODE_LOCAL);
 }
 
 static gboolean
 require_key_subkeys (SeahorseGpgmeKey *self)
 {
-	return require_key_public (self, GPGME_KEYLIST_MODE_LOCAL);
+	return is_key_cached (self) ||
+	       require_key_public (self, GPGME_KEYLIST_MODE_LOCAL);
+}
+
+static void
+on_key_photos_loaded (GObject *source,
+                      GAsyncResult *result,
+                      gpointer user_data)
+{
+	SeahorseGpgmeKey *self = SEAHORSE_GPGME_KEY (source);
+	GError *error = NULL;
+	GList *photos;
+
+	self->pv->photos_loading = FALSE;
+
+	/* Don't try again on every lookup, a refresh of the key retries */
+	photos = seahorse_gpgme_photo_loader_load_finish (self, result, &error);
+	if (error != NULL) {
+		g_message ("couldn't load key photos: %s", error->message);
+		g_error_free (error);
+		self->pv->photos_loaded = TRUE;
+		return;
+	}
+
+	seahorse_pgp_key_set_photos (SEAHORSE_PGP_KEY (self), photos);
+	seahorse_object_list_free (photos);
 }
 
+/* Photos show up through a notify once they have been loaded */
 static void
 load_key_photos (SeahorseGpgmeKey *self)
 {
-	gpgme_error_t gerr;
-	
-	if (self->pv->block_loading)
+	GList *photos;
+
+	if (self->pv->block_loading || self->pv->photos_loading)
 		return;
 
-	gerr = seahorse_gpgme_key_op_photos_load (self);
-	if (!GPG_IS_OK (gerr)) 
-		g_message ("couldn't load key photos: %s", gpgme_strerror (gerr));
-	else
-		self->pv->photos_loaded = TRUE;
+	if (seahorse_gpgme_photo_loader_lookup (self, &photos)) {
+		seahorse_pgp_key_set_photos (SEAHORSE_PGP_KEY (self), photos);
+		seahorse_object_list_free (photos);
+		return;
+	}
+
+	self->pv->photos_loading = TRUE;
+	seahorse_gpgme_photo_loader_load_async (self, NULL, on_key_photos_loaded, NULL);
 }
 
 static gboolean
@@ -249,6 +296,7 @@ realize_uids (SeahorseGpgmeKey *self)
 	gboolean changed = FALSE;
 	GList *uids;
 
+	/* UIDs brought up to date in place don't change the list itself */
 	uids = self->pv->uids;
 	guid = self->pv->pubkey ? self->pv->pubkey->uids : NULL;
 
@@ -260,10 +308,8 @@ realize_uids (SeahorseGpgmeKey *self)
 
 		/* Bring this UID up to date */
 		if (guid && seahorse_gpgme_uid_is_same (uid, guid)) {
-			if (seahorse_gpgme_uid_get_userid (uid) != guid) {
+			if (seahorse_gpgme_uid_get_userid (uid) != guid)
 				g_object_set (uid, "pubkey", self->pv->pubkey, "userid", guid, NULL);
-				changed = TRUE;
-			}
 			results = seahorse_object_list_append (results, uid);
 			guid = guid->next;
 		}
@@ -278,6 +324,9 @@ realize_uids (SeahorseGpgmeKey *self)
 		guid = guid->next;
 	}
 
+	if (g_list_length (results) != g_list_length (self->pv->uids))
+		changed = TRUE;
+
 	if (changed)
 		seahorse_pgp_key_set_uids (SEAHORSE_PGP_KEY (self), results);
 	seahorse_object_list_free (results);
@@ -289,6 +338,11 @@ realize_subkeys (SeahorseGpgmeKey *self)
 	gpgme_subkey_t gsubkey;
 	SeahorseGpgmeSubkey *subkey;
 	GList *list = NULL;
+
+	/* Only the public key determines the subkeys */
+	if (self->pv->subkeys_realized)
+		return;
+	self->pv->subkeys_realized = TRUE;
 	
 	if (self->pv->pubkey) {
 
@@ -377,15 +431,173 @@ seahorse_gpgme_key_ensure_signatures (SeahorseGpgmeKey *self)
 	require_key_public (self, GPGME_KEYLIST_MODE_LOCAL | GPGME_KEYLIST_MODE_SIGS);
 }
 
+/* -----------------------------------------------------------------------------
+ * REFRESH COALESCING
+ *
+ * Keys refreshed during one main loop iteration are listed again together,
+ * with one keylist operation per list mode, instead of one gpg per key.
+ */
+
+/* Most patterns to pass to gpg in one go */
+#define REFRESH_BATCH 256
+
+static GHashTable *refresh_pending = NULL;
+static guint refresh_source = 0;
+
+static void
+refresh_list_batch (GPtrArray *batch,
+                    int mode,
+                    int secret)
+{
+	SeahorseGpgmeKey *self;
+	GHashTable *by_keyid;
+	const gchar **patterns;
+	const gchar *keyid;
+	gpgme_error_t gerr;
+	gpgme_key_t key;
+	gpgme_ctx_t ctx;
+	guint i, n;
+
+	by_keyid = g_hash_table_new (seahorse_pgp_keyid_hash, seahorse_pgp_keyid_equal);
+	patterns = g_new0 (const gchar *, batch->len + 1);
+	for (i = 0, n = 0; i < batch->len; i++) {
+		keyid = seahorse_pgp_key_get_keyid (batch->pdata[i]);
+		if (keyid == NULL)
+			continue;
+		patterns[n++] = keyid;
+		g_hash_table_insert (by_keyid, (gpointer)keyid, batch->pdata[i]);
+	}
+
+	ctx = seahorse_gpgme_keyring_acquire_context (&gerr);
+	if (ctx != NULL && n > 0) {
+		gpgme_set_keylist_mode (ctx, mode);
+		gerr = gpgme_op_keylist_ext_start (ctx, patterns, secret, 0);
+		while (GPG_IS_OK (gerr)) {
+			gerr = gpgme_op_keylist_next (ctx, &key);
+			if (!GPG_IS_OK (gerr))
+				break;
+
+			self = NULL;
+			if (key->subkeys && key->subkeys->keyid)
+				self = g_hash_table_lookup (by_keyid, key->subkeys->keyid);
+			if (self != NULL) {
+				if (secret) {
+					seahorse_gpgme_key_set_private (self, key);
+				} else {
+					self->pv->list_mode = mode;
+					seahorse_gpgme_key_set_public (self, key);
+				}
+			}
+
+			gpgme_key_unref (key);
+		}
+		gpgme_op_keylist_end (ctx);
+	}
+
+	seahorse_gpgme_keyring_release_context (ctx);
+
+	if (gpgme_err_code (gerr) != GPG_ERR_EOF && !GPG_IS_OK (gerr))
+		g_message ("couldn't refresh GPGME keys: %s", gpgme_strerror (gerr));
+
+	g_hash_table_destroy (by_keyid);
+	g_free (patterns);
+}
+
+static void
+refresh_list_keys (GList *keys,
+                   int mode,
+                   int secret)
+{
+	GPtrArray *batch;
+	GList *l;
+
+	batch = g_ptr_array_sized_new (REFRESH_BATCH);
+	for (l = keys; l != NULL; l = g_list_next (l)) {
+		g_ptr_array_add (batch, l->data);
+		if (batch->len == REFRESH_BATCH) {
+			refresh_list_batch (batch, mode, secret);
+			g_ptr_array_set_size (batch, 0);
+		}
+	}
+
+	if (batch->len > 0)
+		refresh_list_batch (batch, mode, secret);
+	g_ptr_array_free (batch, TRUE);
+}
+
+static gboolean
+on_idle_refresh_keys (gpointer unused)
+{
+	GHashTable *by_mode;
+	GHashTable *pending;
+	GHashTableIter iter;
+	SeahorseGpgmeKey *self;
+	GList *secret = NULL;
+	GList *photos = NULL;
+	GList *keys, *l;
+	gpointer mode;
+
+	/* Keys refreshed from here on go into the next batch */
+	pending = refresh_pending;
+	refresh_pending = NULL;
+	refresh_source = 0;
+
+	by_mode = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	g_hash_table_iter_init (&iter, pending);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&self, NULL)) {
+		if (self->pv->block_loading)
+			continue;
+		if (self->pv->pubkey) {
+			mode = GINT_TO_POINTER (self->pv->list_mode);
+			keys = g_hash_table_lookup (by_mode, mode);
+			g_hash_table_insert (by_mode, mode, g_list_prepend (keys, self));
+		}
+		if (self->pv->seckey)
+			secret = g_list_prepend (secret, self);
+		if (self->pv->photos_loaded)
+			photos = g_list_prepend (photos, self);
+	}
+
+	g_hash_table_iter_init (&iter, by_mode);
+	while (g_hash_table_iter_next (&iter, &mode, (gpointer *)&keys)) {
+		refresh_list_keys (keys, GPOINTER_TO_INT (mode), FALSE);
+		g_list_free (keys);
+	}
+
+	refresh_list_keys (secret, GPGME_KEYLIST_MODE_LOCAL, TRUE);
+	g_list_free (secret);
+
+	for (l = photos; l != NULL; l = g_list_next (l)) {
+		seahorse_gpgme_photo_loader_forget (l->data);
+		load_key_photos (l->data);
+	}
+	g_list_free (photos);
+
+	g_hash_table_destroy (by_mode);
+	g_hash_table_destroy (pending);
+	return FALSE; /* don't run again */
+}
+
+/**
+ * seahorse_gpgme_key_refresh
+ * @self: The key
+ *
+ * Lists the key again from the keyring. This happens in the next main loop
+ * iteration, together with all other keys refreshed until then.
+ **/
 void
 seahorse_gpgme_key_refresh (SeahorseGpgmeKey *self)
 {
-	if (self->pv->pubkey)
-		load_key_public (self, self->pv->list_mode);
-	if (self->pv->seckey)
-		load_key_private (self);
-	if (self->pv->photos_loaded)
-		load_key_photos (self);
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (self));
+
+	if (refresh_pending == NULL)
+		refresh_pending = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+		                                         g_object_unref, NULL);
+	g_hash_table_insert (refresh_pending, g_object_ref (self), NULL);
+
+	if (refresh_source == 0)
+		refresh_source = g_idle_add (on_idle_refresh_keys, NULL);
 }
 
 static GList*
@@ -623,6 +835,67 @@ seahorse_gpgme_key_new (SeahorsePlace *sksrc,
 	                     NULL);
 }
 
+/**
+ * seahorse_gpgme_key_new_cached
+ * @sksrc: The keyring the key belongs to
+ * @entry: The key cache entry
+ *
+ * Creates a key from the key cache, without running gpg. It only has
+ * its primary UID and subkey until the keyring lists the real key.
+ *
+ * Returns: The new key
+ **/
+SeahorseGpgmeKey *
+seahorse_gpgme_key_new_cached (SeahorsePlace *sksrc,
+                               const SeahorseGpgmeCacheEntry *entry)
+{
+	SeahorseGpgmeKey *self;
+	SeahorsePgpSubkey *subkey;
+	SeahorsePgpUid *uid;
+	GtkActionGroup *actions;
+	GList *list;
+
+	g_return_val_if_fail (entry != NULL, NULL);
+	g_return_val_if_fail (entry->keyid != NULL, NULL);
+
+	self = g_object_new (SEAHORSE_TYPE_GPGME_KEY, "place", sksrc, NULL);
+	self->pv->cached = TRUE;
+	self->pv->cached_validity = entry->validity;
+	self->pv->cached_trust = entry->trust;
+
+	subkey = seahorse_pgp_subkey_new ();
+	seahorse_pgp_subkey_set_keyid (subkey, entry->keyid);
+	seahorse_pgp_subkey_set_fingerprint (subkey, entry->fingerprint);
+	seahorse_pgp_subkey_set_algorithm (subkey, entry->algo);
+	seahorse_pgp_subkey_set_length (subkey, entry->length);
+	seahorse_pgp_subkey_set_created (subkey, entry->created);
+	seahorse_pgp_subkey_set_expires (subkey, entry->expires);
+	list = g_list_prepend (NULL, subkey);
+	seahorse_pgp_key_set_subkeys (SEAHORSE_PGP_KEY (self), list);
+	seahorse_object_list_free (list);
+
+	/* Not a real gpgme UID, so bypass our own UID bookkeeping */
+	uid = seahorse_pgp_uid_new (SEAHORSE_PGP_KEY (self), NULL);
+	seahorse_pgp_uid_set_name (uid, entry->name);
+	seahorse_pgp_uid_set_email (uid, entry->email);
+	seahorse_pgp_uid_set_comment (uid, entry->comment);
+	seahorse_pgp_uid_set_validity (uid, entry->validity);
+	list = g_list_prepend (NULL, uid);
+	SEAHORSE_PGP_KEY_CLASS (seahorse_gpgme_key_parent_class)->set_uids (SEAHORSE_PGP_KEY (self), list);
+	seahorse_object_list_free (list);
+
+	actions = seahorse_gpgme_key_actions_instance ();
+	g_object_set (self,
+	              "usage", entry->usage,
+	              "object-flags", entry->flags,
+	              "actions", actions,
+	              NULL);
+	g_object_unref (actions);
+
+	seahorse_pgp_key_realize (SEAHORSE_PGP_KEY (self));
+	return self;
+}
+
 gpgme_key_t
 seahorse_gpgme_key_get_public (SeahorseGpgmeKey *self)
 {
@@ -632,31 +905,114 @@ seahorse_gpgme_key_get_public (SeahorseGpgmeKey *self)
 	return NULL;
 }
 
+/* Whether two listings of a key would produce the same subkey objects */
+static gboolean
+subkeys_equal (gpgme_key_t prev,
+               gpgme_key_t key)
+{
+	gpgme_subkey_t psub, sub;
+
+	/* Subkey names come from the primary UID */
+	if (!prev->uids != !key->uids ||
+	    (prev->uids && g_strcmp0 (prev->uids->uid, key->uids->uid) != 0))
+		return FALSE;
+
+	for (psub = prev->subkeys, sub = key->subkeys; psub && sub;
+	     psub = psub->next, sub = sub->next) {
+		if (g_strcmp0 (psub->fpr, sub->fpr) != 0 ||
+		    g_strcmp0 (psub->keyid, sub->keyid) != 0 ||
+		    psub->pubkey_algo != sub->pubkey_algo ||
+		    psub->length != sub->length ||
+		    psub->timestamp != sub->timestamp ||
+		    psub->expires != sub->expires ||
+		    psub->revoked != sub->revoked ||
+		    psub->expired != sub->expired ||
+		    psub->disabled != sub->disabled ||
+		    psub->invalid != sub->invalid ||
+		    psub->can_encrypt != sub->can_encrypt ||
+		    psub->can_sign != sub->can_sign ||
+		    psub->can_certify != sub->can_certify ||
+		    psub->can_authenticate != sub->can_authenticate)
+			return FALSE;
+	}
+
+	return psub == NULL && sub == NULL;
+}
+
+/* Notify about the properties that differ between two listings of a key */
+static void
+notify_changed_details (GObject *obj,
+                        gpgme_key_t prev,
+                        gpgme_key_t key)
+{
+	gpgme_subkey_t psub, sub;
+	gboolean status;
+
+	/* Nothing to compare against, such as keys from the cache */
+	if (!prev || !key || !prev->subkeys || !key->subkeys) {
+		g_object_notify (obj, "fingerprint");
+		g_object_notify (obj, "validity");
+		g_object_notify (obj, "trust");
+		g_object_notify (obj, "expires");
+		g_object_notify (obj, "length");
+		g_object_notify (obj, "algo");
+		return;
+	}
+
+	psub = prev->subkeys;
+	sub = key->subkeys;
+	status = prev->revoked != key->revoked || prev->disabled != key->disabled ||
+	         prev->expired != key->expired;
+
+	if (g_strcmp0 (psub->fpr, sub->fpr) != 0)
+		g_object_notify (obj, "fingerprint");
+	if (status || !prev->uids != !key->uids ||
+	    (prev->uids && prev->uids->validity != key->uids->validity))
+		g_object_notify (obj, "validity");
+	if (status || prev->owner_trust != key->owner_trust)
+		g_object_notify (obj, "trust");
+	if (psub->expires != sub->expires)
+		g_object_notify (obj, "expires");
+	if (psub->length != sub->length)
+		g_object_notify (obj, "length");
+	if (psub->pubkey_algo != sub->pubkey_algo)
+		g_object_notify (obj, "algo");
+}
+
 void
 seahorse_gpgme_key_set_public (SeahorseGpgmeKey *self, gpgme_key_t key)
 {
+	gpgme_key_t prev;
 	GObject *obj;
 	
 	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (self));
 	
+	/* Keep the previous listing around to compare against */
+	prev = self->pv->cached ? NULL : self->pv->pubkey;
+	if (prev != NULL)
+		gpgme_key_ref (prev);
+
 	if (self->pv->pubkey)
 		gpgme_key_unref (self->pv->pubkey);
 	self->pv->pubkey = key;
+
+	/* Unchanged subkeys keep their objects, which hold the old listing */
+	if (!prev || !key || !subkeys_equal (prev, key))
+		self->pv->subkeys_realized = FALSE;
 	if (self->pv->pubkey) {
 		gpgme_key_ref (self->pv->pubkey);
 		self->pv->list_mode |= self->pv->pubkey->keylist_mode;
+		self->pv->cached = FALSE;
 	}
 	
 	obj = G_OBJECT (self);
 	g_object_freeze_notify (obj);
 	seahorse_gpgme_key_realize (self);
-	g_object_notify (obj, "fingerprint");
-	g_object_notify (obj, "validity");
-	g_object_notify (obj, "trust");
-	g_object_notify (obj, "expires");
-	g_object_notify (obj, "length");
-	g_object_notify (obj, "algo");
+	notify_changed_details (obj, prev, self->pv->pubkey);
 	g_object_thaw_notify (obj);
+
+	if (prev != NULL)
+		gpgme_key_unref (prev);
 }
 
 gpgme_key_t
@@ -691,7 +1047,9 @@ SeahorseValidity
 seahorse_gpgme_key_get_validity (SeahorseGpgmeKey *self)
 {
 	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (self), SEAHORSE_VALIDITY_UNKNOWN);
-	
+
+	if (is_key_cached (self))
+		return self->pv->cached_validity;
 	if (!require_key_public (self, GPGME_KEYLIST_MODE_LOCAL))
 		return SEAHORSE_VALIDITY_UNKNOWN;
 	
@@ -709,6 +1067,8 @@ SeahorseValidity
 seahorse_gpgme_key_get_trust (SeahorseGpgmeKey *self)
 {
 	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (self), SEAHORSE_VALIDITY_UNKNOWN);
+	if (is_key_cached (self))
+		return self->pv->cached_trust;
 	if (!require_key_public (self, GPGME_KEYLIST_MODE_LOCAL))
 		return SEAHORSE_VALIDITY_UNKNOWN;
 	
@@ -24,6 +24,7 @@
 
 #include <gpgme.h>
 
+#include "seahorse-gpgme-cache.h"
 #include "seahorse-pgp-key.h"
 
 #define SEAHORSE_TYPE_GPGME_KEY            (seahorse_gpgme_key_get_type ())
@@ -51,6 +52,9 @@ SeahorseGpgmeKey* seahorse_gpgme_key_new                 (SeahorsePlace *sksrc,
                                                           gpgme_key_t pubkey,
                                                           gpgme_key_t seckey);
 
+SeahorseGpgmeKey* seahorse_gpgme_key_new_cached          (SeahorsePlace *sksrc,
+                                                          const SeahorseGpgmeCacheEntry *entry);
+
 void              seahorse_gpgme_key_refresh              (SeahorseGpgmeKey *self);
 
 void              seahorse_gpgme_key_realize              (SeahorseGpgmeKey *self);
@@ -25,6 +25,7 @@
 
 #include "seahorse-gpgme-keyring.h"
 
+#include "seahorse-gpgme-cache.h"
 #include "seahorse-gpgme-data.h"
 #include "seahorse-gpgme.h"
 #include "seahorse-gpgme-key-op.h"
@@ -60,9 +61,11 @@ enum {
 /* Amount of keys to load in a batch */
 #define DEFAULT_LOAD_BATCH 50
 
+/* Amount of idle listing contexts to keep around */
+#define MAX_POOLED_CONTEXTS 4
+
 enum {
-	LOAD_FULL = 0x01,
-	LOAD_PHOTOS = 0x02
+	LOAD_FULL = 0x01
 };
 
 static gpgme_error_t
@@ -125,13 +128,20 @@ passphrase_get (gconstpointer dummy, const gchar *passphrase_hint,
 struct _SeahorseGpgmeKeyringPrivate {
 	GHashTable *keys;
 	guint scheduled_refresh;                /* Source for refresh timeout */
+	gboolean blocked;                       /* The scheduled refresh is a dummy */
+	gboolean changed_while_blocked;         /* Files changed during the dummy */
+	gboolean refreshing;                    /* A scheduled refresh is running */
+	gboolean refresh_again;                 /* Files changed during the refresh */
+	GBytes *stamp;                          /* Keyring files when last fully listed */
+	GHashTable *digests;                    /* Digests of the listed public keys */
 	GFileMonitor *monitor_handle;           /* For monitoring the .gnupg directory */
-	GList *orphan_secret;                   /* Orphan secret keys */
 	GtkActionGroup *actions;
 };
 
 static void     seahorse_gpgme_keyring_place_iface        (SeahorsePlaceIface *iface);
 
+static gboolean scheduled_refresh                         (gpointer user_data);
+
 static void     seahorse_gpgme_keyring_collection_iface   (GcrCollectionIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (SeahorseGpgmeKeyring, seahorse_gpgme_keyring, G_TYPE_OBJECT,
@@ -142,38 +152,83 @@ G_DEFINE_TYPE_WITH_CODE (SeahorseGpgmeKeyring, seahorse_gpgme_keyring, G_TYPE_OB
 typedef struct {
 	SeahorseGpgmeKeyring *keyring;
 	GCancellable *cancellable;
-	gulong cancelled_sig;
 	gpgme_ctx_t gctx;
 	GHashTable *checks;
+	GHashTable *pending_secret;             /* Shared by the listings of one load */
 	gint parts;
 	gint loaded;
+
+	/* Shared with the listing thread, protected by mutex */
+	GMutex mutex;
+	GQueue *batches;                        /* GPtrArray of gpgme_key_t */
+	guint merging;                          /* Source for merging batches */
+	gboolean listed;                        /* Listing thread is done */
 } keyring_list_closure;
 
+static void
+keyring_list_batch_free (gpointer data)
+{
+	GPtrArray *batch = data;
+	g_ptr_array_foreach (batch, (GFunc)gpgme_key_unref, NULL);
+	g_ptr_array_free (batch, TRUE);
+}
+
 static void
 keyring_list_free (gpointer data)
 {
 	keyring_list_closure *closure = data;
+	g_assert (closure->merging == 0);
 	if (closure->gctx)
 		gpgme_release (closure->gctx);
 	if (closure->checks)
 		g_hash_table_destroy (closure->checks);
-	g_cancellable_disconnect (closure->cancellable,
-	                          closure->cancelled_sig);
+	if (closure->pending_secret)
+		g_hash_table_unref (closure->pending_secret);
+	g_queue_free_full (closure->batches, keyring_list_batch_free);
+	g_mutex_clear (&closure->mutex);
 	g_clear_object (&closure->cancellable);
 	g_clear_object (&closure->keyring);
 	g_free (closure);
 }
 
-/* Add a key to the context  */
+/*
+ * A digest of everything about a listed public key that we show. Used to
+ * tell which keys changed without building objects for all of them.
+ */
+static gchar *
+calc_key_digest (gpgme_key_t key)
+{
+	gpgme_subkey_t subkey;
+	gpgme_user_id_t uid;
+	GString *data;
+	gchar *digest;
+
+	data = g_string_sized_new (256);
+	g_string_append_printf (data, "%d%d%d%d:%d|", key->revoked, key->expired,
+	                        key->disabled, key->invalid, key->owner_trust);
+	for (subkey = key->subkeys; subkey != NULL; subkey = subkey->next)
+		g_string_append_printf (data, "%s:%ld:%ld:%d%d%d|",
+		                        subkey->keyid, subkey->timestamp, subkey->expires,
+		                        subkey->revoked, subkey->expired, subkey->disabled);
+	for (uid = key->uids; uid != NULL; uid = uid->next)
+		g_string_append_printf (data, "%s:%d:%d%d|", uid->uid ? uid->uid : "",
+		                        uid->validity, uid->revoked, uid->invalid);
+
+	digest = g_compute_checksum_for_string (G_CHECKSUM_MD5, data->str, data->len);
+	g_string_free (data, TRUE);
+	return digest;
+}
+
+/* Add a key to the context, new keys are appended to added */
 static SeahorseGpgmeKey*
 add_key_to_context (SeahorseGpgmeKeyring *self,
-                    gpgme_key_t key)
+                    gpgme_key_t key,
+                    GHashTable *pending_secret,
+                    GPtrArray *added)
 {
 	SeahorseGpgmeKey *pkey = NULL;
 	SeahorseGpgmeKey *prev;
 	const gchar *keyid;
-	gpgme_key_t seckey;
-	GList *l;
 
 	g_return_val_if_fail (key->subkeys && key->subkeys->keyid, NULL);
 
@@ -197,7 +252,7 @@ add_key_to_context (SeahorseGpgmeKeyring *self,
 		pkey = seahorse_gpgme_key_new (SEAHORSE_PLACE (self), NULL, key);
 
 		/* Since we don't have a public key yet, save this away */
-		self->pv->orphan_secret = g_list_append (self->pv->orphan_secret, pkey);
+		g_hash_table_replace (pending_secret, g_strdup (keyid), pkey);
 
 		/* No key was loaded as far as everyone is concerned */
 		return NULL;
@@ -205,33 +260,24 @@ add_key_to_context (SeahorseGpgmeKeyring *self,
 
 	/* Just a new public key */
 
-	/* Check for orphans */
-	for (l = self->pv->orphan_secret; l; l = g_list_next (l)) {
+	/* Check for a secret key waiting on this one */
+	pkey = g_hash_table_lookup (pending_secret, keyid);
+	if (pkey != NULL) {
 
-		seckey = seahorse_gpgme_key_get_private (l->data);
-		g_return_val_if_fail (seckey && seckey->subkeys && seckey->subkeys->keyid, NULL);
-		g_assert (seckey);
+		/* Take the pending key out of the table, keeping our reference */
+		g_object_ref (pkey);
+		g_hash_table_remove (pending_secret, keyid);
 
-		/* Look for a matching key */
-		if (g_str_equal (keyid, seckey->subkeys->keyid)) {
+		/* Set it up properly */
+		g_object_set (pkey, "pubkey", key, NULL);
 
-			/* Set it up properly */
-			pkey = SEAHORSE_GPGME_KEY (l->data);
-			g_object_set (pkey, "pubkey", key, NULL);
-
-			/* Remove item from orphan list cleanly */
-			self->pv->orphan_secret = g_list_remove_link (self->pv->orphan_secret, l);
-			g_list_free (l);
-			break;
-		}
-	}
-
-	if (pkey == NULL)
+	} else {
 		pkey = seahorse_gpgme_key_new (SEAHORSE_PLACE (self), key, NULL);
+	}
 
 	/* Add to context */
 	g_hash_table_insert (self->pv->keys, g_strdup (keyid), pkey);
-	gcr_collection_emit_added (GCR_COLLECTION (self), G_OBJECT (pkey));
+	g_ptr_array_add (added, pkey);
 
 	return pkey;
 }
@@ -249,42 +295,36 @@ remove_key (SeahorseGpgmeKeyring *self,
 		seahorse_gpgme_keyring_remove_key (self, key);
 }
 
-/* Completes one batch of key loading */
-static gboolean
-on_idle_list_batch_of_keys (gpointer data)
+/* Merges one batch of listed keys into the keyring */
+static void
+merge_batch_of_keys (keyring_list_closure *closure,
+                     GPtrArray *batch)
 {
-	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (data);
-	keyring_list_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
 	SeahorseGpgmeKey *pkey;
+	SeahorseGpgmeKey *prev;
+	GPtrArray *added;
+	GHashTable *frozen;
 	GHashTableIter iter;
 	gpgme_key_t key;
-	guint batch;
-	gchar *detail;
-	const gchar *keyid;
-
-	/* We load until done if batch is zero */
-	batch = DEFAULT_LOAD_BATCH;
-
-	while (batch-- > 0) {
-
-		if (!GPG_IS_OK (gpgme_op_keylist_next (closure->gctx, &key))) {
-
-			gpgme_op_keylist_end (closure->gctx);
-
-			/* If we were a refresh loader, then we remove the keys we didn't find */
-			if (closure->checks) {
-				g_hash_table_iter_init (&iter, closure->checks);
-				while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, NULL))
-					remove_key (closure->keyring, keyid);
-			}
+	guint i;
 
-			seahorse_progress_end (closure->cancellable, res);
-			g_simple_async_result_complete (res);
-			return FALSE; /* Remove event handler */
+	added = g_ptr_array_sized_new (batch->len);
+	frozen = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	for (i = 0; i < batch->len; i++) {
+		key = batch->pdata[i];
+
+		/*
+		 * Keys we already have get their public and secret parts set
+		 * separately. Hold back their notifications until the whole
+		 * batch is merged, so that each property notifies only once.
+		 */
+		prev = seahorse_gpgme_keyring_lookup (closure->keyring, key->subkeys->keyid);
+		if (prev != NULL && !g_hash_table_lookup (frozen, prev)) {
+			g_object_freeze_notify (G_OBJECT (prev));
+			g_hash_table_insert (frozen, g_object_ref (prev), prev);
 		}
 
-		g_return_val_if_fail (key->subkeys && key->subkeys->keyid, FALSE);
-
 		/* During a refresh if only new or removed keys */
 		if (closure->checks) {
 
@@ -293,31 +333,143 @@ on_idle_list_batch_of_keys (gpointer data)
 
 		}
 
-		pkey = add_key_to_context (closure->keyring, key);
+		pkey = add_key_to_context (closure->keyring, key, closure->pending_secret, added);
 
-		/* Load additional info */
-		if (pkey && closure->parts & LOAD_PHOTOS)
-			seahorse_gpgme_key_op_photos_load (pkey);
+		/* Remember what the public key looked like, for refreshes */
+		if (pkey && !key->secret)
+			g_hash_table_replace (closure->keyring->pv->digests,
+			                      g_strdup (key->subkeys->keyid),
+			                      calc_key_digest (key));
 
-		gpgme_key_unref (key);
 		closure->loaded++;
 	}
 
-	detail = g_strdup_printf (ngettext("Loaded %d key", "Loaded %d keys", closure->loaded), closure->loaded);
-	seahorse_progress_update (closure->cancellable, res, detail);
-	g_free (detail);
+	g_hash_table_iter_init (&iter, frozen);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&prev, NULL)) {
+		g_object_thaw_notify (G_OBJECT (prev));
+		g_object_unref (prev);
+	}
+	g_hash_table_destroy (frozen);
 
-	return TRUE;
+	/* Only announce the keys once the whole batch is in place */
+	for (i = 0; i < added->len; i++)
+		gcr_collection_emit_added (GCR_COLLECTION (closure->keyring), added->pdata[i]);
+
+	g_ptr_array_free (added, TRUE);
+}
+
+/* Merges the batches the listing thread has produced so far */
+static gboolean
+on_idle_merge_batches_of_keys (gpointer data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (data);
+	keyring_list_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GHashTableIter iter;
+	GQueue *batches;
+	GPtrArray *batch;
+	gboolean listed;
+	const gchar *keyid;
+
+	g_mutex_lock (&closure->mutex);
+	batches = closure->batches;
+	closure->batches = g_queue_new ();
+	listed = closure->listed;
+	closure->merging = 0;
+	g_mutex_unlock (&closure->mutex);
+
+	while ((batch = g_queue_pop_head (batches)) != NULL) {
+		merge_batch_of_keys (closure, batch);
+		keyring_list_batch_free (batch);
+	}
+
+	g_queue_free (batches);
+
+	if (!listed) {
+		seahorse_progress_update (closure->cancellable, res,
+		                          ngettext ("Loaded %d key", "Loaded %d keys", closure->loaded),
+		                          closure->loaded);
+		return FALSE; /* The listing thread schedules us again */
+	}
+
+	/* If we were a refresh loader, then we remove the keys we didn't find */
+	if (closure->checks && !g_cancellable_is_cancelled (closure->cancellable)) {
+		g_hash_table_iter_init (&iter, closure->checks);
+		while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, NULL))
+			remove_key (closure->keyring, keyid);
+	}
+
+	seahorse_progress_end (closure->cancellable, res);
+	g_simple_async_result_complete (res);
+	return FALSE; /* Remove event handler */
 }
 
+/* Hands a batch over to the main loop, called with the mutex held */
 static void
-on_keyring_list_cancelled (GCancellable *cancellable,
-                           gpointer user_data)
+queue_batch_of_keys (GSimpleAsyncResult *res,
+                     keyring_list_closure *closure,
+                     GPtrArray *batch)
 {
-	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	if (batch->len > 0)
+		g_queue_push_tail (closure->batches, batch);
+	else
+		g_ptr_array_free (batch, TRUE);
+
+	if (closure->merging == 0)
+		closure->merging = g_idle_add_full (G_PRIORITY_LOW, on_idle_merge_batches_of_keys,
+		                                    g_object_ref (res), g_object_unref);
+}
+
+/* Drops the listing thread's reference to the result on the main loop */
+static gboolean
+on_idle_release_listing (gpointer data)
+{
+	return FALSE; /* The destroy notify does the work */
+}
+
+/* Runs in its own thread, with its own gpgme context */
+static gpointer
+keyring_list_thread (gpointer data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (data);
 	keyring_list_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GPtrArray *batch;
+	gpgme_key_t key;
+
+	batch = g_ptr_array_sized_new (DEFAULT_LOAD_BATCH);
+
+	while (!g_cancellable_is_cancelled (closure->cancellable) &&
+	       GPG_IS_OK (gpgme_op_keylist_next (closure->gctx, &key))) {
+
+		if (key->subkeys == NULL || key->subkeys->keyid == NULL) {
+			g_warning ("skipping listed key without a key id");
+			gpgme_key_unref (key);
+			continue;
+		}
+
+		g_ptr_array_add (batch, key);
+		if (batch->len < DEFAULT_LOAD_BATCH)
+			continue;
+
+		g_mutex_lock (&closure->mutex);
+		queue_batch_of_keys (res, closure, batch);
+		g_mutex_unlock (&closure->mutex);
+
+		batch = g_ptr_array_sized_new (DEFAULT_LOAD_BATCH);
+	}
 
 	gpgme_op_keylist_end (closure->gctx);
+
+	g_mutex_lock (&closure->mutex);
+	closure->listed = TRUE;
+	queue_batch_of_keys (res, closure, batch);
+	g_mutex_unlock (&closure->mutex);
+
+	/*
+	 * The merges can complete and drop their references before we get
+	 * here, so never release the last reference on this thread.
+	 */
+	g_idle_add_full (G_PRIORITY_LOW, on_idle_release_listing, res, g_object_unref);
+	return NULL;
 }
 
 static void
@@ -325,6 +477,7 @@ seahorse_gpgme_keyring_list_async (SeahorseGpgmeKeyring *self,
                                    const gchar **patterns,
                                    gint parts,
                                    gboolean secret,
+                                   GHashTable *pending_secret,
                                    GCancellable *cancellable,
                                    GAsyncReadyCallback callback,
                                    gpointer user_data)
@@ -335,6 +488,7 @@ seahorse_gpgme_keyring_list_async (SeahorseGpgmeKeyring *self,
 	gpgme_error_t gerr = 0;
 	GHashTableIter iter;
 	GError *error = NULL;
+	GThread *thread;
 	gchar *keyid;
 
 	res = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
@@ -345,10 +499,15 @@ seahorse_gpgme_keyring_list_async (SeahorseGpgmeKeyring *self,
 	closure->gctx = seahorse_gpgme_keyring_new_context (&gerr);
 	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
 	closure->keyring = g_object_ref (self);
+	closure->pending_secret = g_hash_table_ref (pending_secret);
+	closure->batches = g_queue_new ();
+	g_mutex_init (&closure->mutex);
 	g_simple_async_result_set_op_res_gpointer (res, closure, keyring_list_free);
 
 	/* Start the key listing */
 	if (closure->gctx) {
+		/* Listing never needs a passphrase, and we can't prompt from a thread */
+		gpgme_set_passphrase_cb (closure->gctx, NULL, NULL);
 		if (parts & LOAD_FULL)
 			gpgme_set_keylist_mode (closure->gctx, GPGME_KEYLIST_MODE_SIGS |
 			                        gpgme_get_keylist_mode (closure->gctx));
@@ -383,13 +542,10 @@ seahorse_gpgme_keyring_list_async (SeahorseGpgmeKeyring *self,
 	}
 
 	seahorse_progress_prep_and_begin (cancellable, res, NULL);
-	if (cancellable)
-		closure->cancelled_sig = g_cancellable_connect (cancellable,
-		                                                G_CALLBACK (on_keyring_list_cancelled),
-		                                                res, NULL);
 
-	g_idle_add_full (G_PRIORITY_LOW, on_idle_list_batch_of_keys,
-	                 g_object_ref (res), g_object_unref);
+	/* The listing thread owns this reference until it's done */
+	thread = g_thread_new ("gpgme-keylist", keyring_list_thread, g_object_ref (res));
+	g_thread_unref (thread);
 
 	g_object_unref (res);
 }
@@ -416,6 +572,19 @@ cancel_scheduled_refresh (SeahorseGpgmeKeyring *self)
 		g_source_remove (self->pv->scheduled_refresh);
 		self->pv->scheduled_refresh = 0;
 	}
+	self->pv->blocked = FALSE;
+}
+
+static void
+schedule_refresh (SeahorseGpgmeKeyring *self)
+{
+	if (self->pv->refreshing) {
+		self->pv->refresh_again = TRUE;
+	} else {
+		cancel_scheduled_refresh (self);
+		self->pv->scheduled_refresh = g_timeout_add (500, scheduled_refresh, self);
+	}
+	self->pv->changed_while_blocked = FALSE;
 }
 
 static gboolean
@@ -424,14 +593,88 @@ scheduled_dummy (gpointer user_data)
 	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (user_data);
 	g_debug ("dummy refresh event occurring now");
 	self->pv->scheduled_refresh = 0;
+	self->pv->blocked = FALSE;
+
+	/* Changes we held back, a refresh skips them if they were our own */
+	if (self->pv->changed_while_blocked) {
+		g_debug ("scheduling refresh event due to changes during dummy");
+		schedule_refresh (self);
+	}
+
 	return FALSE; /* don't run again */
 }
 
+static void
+schedule_dummy_refresh (SeahorseGpgmeKeyring *self)
+{
+	/* This blocks all monitoring for a while */
+	cancel_scheduled_refresh (self);
+	self->pv->scheduled_refresh = g_timeout_add (500, scheduled_dummy, self);
+	self->pv->blocked = TRUE;
+	g_debug ("scheduled a dummy refresh");
+}
+
 typedef struct {
+	GCancellable *cancellable;
+	GBytes *stamp;                          /* Keyring files at start of a full load */
+	GHashTable *pending_secret;             /* Secret keys waiting for their public key */
 	gboolean public_done;
 	gboolean secret_done;
+	gboolean failed;
 } keyring_load_closure;
 
+static void
+keyring_load_free (gpointer data)
+{
+	keyring_load_closure *closure = data;
+	g_clear_object (&closure->cancellable);
+	if (closure->stamp)
+		g_bytes_unref (closure->stamp);
+	g_hash_table_unref (closure->pending_secret);
+	g_free (closure);
+}
+
+static void
+keyring_write_cache (SeahorseGpgmeKeyring *self,
+                     GBytes *stamp)
+{
+	GError *error = NULL;
+	GList *keys;
+
+	/* What we have now matches these keyring files */
+	if (self->pv->stamp)
+		g_bytes_unref (self->pv->stamp);
+	self->pv->stamp = g_bytes_ref (stamp);
+
+	keys = g_hash_table_get_values (self->pv->keys);
+	if (!seahorse_gpgme_cache_write (stamp, keys, &error)) {
+		g_message ("couldn't write the key cache: %s", error->message);
+		g_clear_error (&error);
+	}
+	g_list_free (keys);
+}
+
+static void
+keyring_load_complete (SeahorseGpgmeKeyring *self,
+                       GSimpleAsyncResult *res)
+{
+	keyring_load_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+
+	/* A complete listing confirms or repairs the key cache */
+	if (closure->stamp && !closure->failed &&
+	    !g_cancellable_is_cancelled (closure->cancellable))
+		keyring_write_cache (self, closure->stamp);
+
+	/* Secret keys that never got a public key aren't going to get one now */
+	if (g_hash_table_size (closure->pending_secret) > 0) {
+		g_debug ("dropping %u secret keys without public keys",
+		         g_hash_table_size (closure->pending_secret));
+		g_hash_table_remove_all (closure->pending_secret);
+	}
+
+	g_simple_async_result_complete (res);
+}
+
 static void
 on_keyring_secret_list_complete (GObject *source,
                                  GAsyncResult *result,
@@ -442,12 +685,14 @@ on_keyring_secret_list_complete (GObject *source,
 	GError *error = NULL;
 
 	if (!seahorse_gpgme_keyring_list_finish (SEAHORSE_GPGME_KEYRING (source),
-	                                         result, &error))
+	                                         result, &error)) {
 		g_simple_async_result_take_error (res, error);
+		closure->failed = TRUE;
+	}
 
 	closure->secret_done = TRUE;
 	if (closure->public_done)
-		g_simple_async_result_complete (res);
+		keyring_load_complete (SEAHORSE_GPGME_KEYRING (source), res);
 
 	g_object_unref (res);
 }
@@ -462,12 +707,14 @@ on_keyring_public_list_complete (GObject *source,
 	GError *error = NULL;
 
 	if (!seahorse_gpgme_keyring_list_finish (SEAHORSE_GPGME_KEYRING (source),
-	                                         result, &error))
+	                                         result, &error)) {
 		g_simple_async_result_take_error (res, error);
+		closure->failed = TRUE;
+	}
 
 	closure->public_done = TRUE;
 	if (closure->secret_done)
-		g_simple_async_result_complete (res);
+		keyring_load_complete (SEAHORSE_GPGME_KEYRING (source), res);
 
 	g_object_unref (res);
 }
@@ -483,26 +730,29 @@ seahorse_gpgme_keyring_load_full_async (SeahorseGpgmeKeyring *self,
 	GSimpleAsyncResult *res;
 	keyring_load_closure *closure;
 
-	/* Schedule a dummy refresh. This blocks all monitoring for a while */
-	cancel_scheduled_refresh (self);
-	self->pv->scheduled_refresh = g_timeout_add (500, scheduled_dummy, self);
-	g_debug ("scheduled a dummy refresh");
+	schedule_dummy_refresh (self);
 
 	g_debug ("refreshing keys...");
 
 	res = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
 	                                 seahorse_gpgme_keyring_load_full_async);
 	closure = g_new0 (keyring_load_closure, 1);
-	g_simple_async_result_set_op_res_gpointer (res, closure, g_free);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	if (patterns == NULL)
+		closure->stamp = seahorse_gpgme_cache_stamp ();
+	closure->pending_secret = g_hash_table_new_full (seahorse_pgp_keyid_hash,
+	                                                 seahorse_pgp_keyid_equal,
+	                                                 g_free, g_object_unref);
+	g_simple_async_result_set_op_res_gpointer (res, closure, keyring_load_free);
 
 	/* Secret keys */
-	seahorse_gpgme_keyring_list_async (self, patterns, 0, TRUE, cancellable,
-	                                  on_keyring_secret_list_complete,
+	seahorse_gpgme_keyring_list_async (self, patterns, 0, TRUE, closure->pending_secret,
+	                                  cancellable, on_keyring_secret_list_complete,
 	                                  g_object_ref (res));
 
 	/* Public keys */
-	seahorse_gpgme_keyring_list_async (self, patterns, 0, FALSE, cancellable,
-	                                  on_keyring_public_list_complete,
+	seahorse_gpgme_keyring_list_async (self, patterns, 0, FALSE, closure->pending_secret,
+	                                  cancellable, on_keyring_public_list_complete,
 	                                  g_object_ref (res));
 
 	g_object_unref (res);
@@ -531,12 +781,47 @@ seahorse_gpgme_keyring_remove_key (SeahorseGpgmeKeyring *self,
 	g_return_if_fail (g_hash_table_lookup (self->pv->keys, keyid) == key);
 
 	g_object_ref (key);
+	g_hash_table_remove (self->pv->digests, keyid);
 	g_hash_table_remove (self->pv->keys, keyid);
 	gcr_collection_emit_removed (GCR_COLLECTION (self), G_OBJECT (key));
 	g_object_unref (key);
 
 }
 
+/* Shows the keys from the key cache, while the real listing runs */
+static void
+load_cached_keys (SeahorseGpgmeKeyring *self)
+{
+	SeahorseGpgmeCacheEntry entry;
+	SeahorseGpgmeCache *cache;
+	SeahorseGpgmeKey *pkey;
+	GPtrArray *added;
+	guint i, length;
+
+	cache = seahorse_gpgme_cache_open ();
+	if (cache == NULL)
+		return;
+
+	length = seahorse_gpgme_cache_get_length (cache);
+	added = g_ptr_array_sized_new (length);
+
+	for (i = 0; i < length; i++) {
+		seahorse_gpgme_cache_get_entry (cache, i, &entry);
+		if (g_hash_table_lookup (self->pv->keys, entry.keyid))
+			continue;
+		pkey = seahorse_gpgme_key_new_cached (SEAHORSE_PLACE (self), &entry);
+		g_hash_table_insert (self->pv->keys, g_strdup (entry.keyid), pkey);
+		g_ptr_array_add (added, pkey);
+	}
+
+	seahorse_gpgme_cache_free (cache);
+	g_debug ("loaded %u keys from the key cache", added->len);
+
+	for (i = 0; i < added->len; i++)
+		gcr_collection_emit_added (GCR_COLLECTION (self), added->pdata[i]);
+	g_ptr_array_free (added, TRUE);
+}
+
 static void
 seahorse_gpgme_keyring_load_async (SeahorsePlace *place,
                                    GCancellable *cancellable,
@@ -544,6 +829,11 @@ seahorse_gpgme_keyring_load_async (SeahorsePlace *place,
                                    gpointer user_data)
 {
 	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (place);
+
+	/* The very first load can show the cached keys straight away */
+	if (g_hash_table_size (self->pv->keys) == 0)
+		load_cached_keys (self);
+
 	seahorse_gpgme_keyring_load_full_async (self, NULL, 0, cancellable,
 	                                        callback, user_data);
 }
@@ -728,6 +1018,270 @@ seahorse_gpgme_keyring_import_finish (SeahorseGpgmeKeyring *self,
 	return results;
 }
 
+typedef struct {
+	GCancellable *cancellable;
+	gpgme_ctx_t gctx;
+	GBytes *stamp;
+	GHashTable *digests;                    /* Known digests, leftovers have vanished */
+	GHashTable *secrets;                    /* Known secret keys, leftovers lost secret */
+	GPtrArray *changed;                     /* Patterns to list again */
+} keyring_refresh_closure;
+
+static void
+keyring_refresh_free (gpointer data)
+{
+	keyring_refresh_closure *closure = data;
+	g_clear_object (&closure->cancellable);
+	if (closure->gctx)
+		gpgme_release (closure->gctx);
+	if (closure->stamp)
+		g_bytes_unref (closure->stamp);
+	g_hash_table_destroy (closure->digests);
+	g_hash_table_destroy (closure->secrets);
+	g_ptr_array_free (closure->changed, TRUE);
+	g_free (closure);
+}
+
+static const gchar *
+key_pattern (gpgme_key_t key)
+{
+	return key->subkeys->fpr ? key->subkeys->fpr : key->subkeys->keyid;
+}
+
+/* Runs in a thread, compares every listed key against what we have */
+static void
+keyring_refresh_thread (GSimpleAsyncResult *listing,
+                        GObject *object,
+                        GCancellable *cancellable)
+{
+	keyring_refresh_closure *closure = g_simple_async_result_get_op_res_gpointer (listing);
+	GError *error = NULL;
+	gpgme_error_t gerr;
+	gpgme_key_t key;
+	gchar *digest;
+	gint secret;
+
+	for (secret = 0; secret < 2; secret++) {
+		gerr = gpgme_op_keylist_start (closure->gctx, NULL, secret);
+		while (GPG_IS_OK (gerr) && !g_cancellable_is_cancelled (cancellable)) {
+			gerr = gpgme_op_keylist_next (closure->gctx, &key);
+			if (!GPG_IS_OK (gerr))
+				break;
+			if (key->subkeys == NULL || key->subkeys->keyid == NULL) {
+				gpgme_key_unref (key);
+				continue;
+			}
+
+			/* Public keys that are new or different */
+			if (!secret) {
+				digest = calc_key_digest (key);
+				if (g_strcmp0 (digest, g_hash_table_lookup (closure->digests,
+				                                            key->subkeys->keyid)) != 0)
+					g_ptr_array_add (closure->changed, g_strdup (key_pattern (key)));
+				g_hash_table_remove (closure->digests, key->subkeys->keyid);
+				g_free (digest);
+
+			/* Secret keys we didn't know about */
+			} else if (!g_hash_table_remove (closure->secrets, key->subkeys->keyid)) {
+				g_ptr_array_add (closure->changed, g_strdup (key_pattern (key)));
+			}
+
+			gpgme_key_unref (key);
+		}
+
+		gpgme_op_keylist_end (closure->gctx);
+
+		if (gpgme_err_code (gerr) != GPG_ERR_EOF &&
+		    seahorse_gpgme_propagate_error (gerr, &error)) {
+			g_simple_async_result_take_error (listing, error);
+			return;
+		}
+
+		if (g_cancellable_set_error_if_cancelled (cancellable, &error)) {
+			g_simple_async_result_take_error (listing, error);
+			return;
+		}
+	}
+}
+
+static void
+on_keyring_refresh_loaded (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	keyring_refresh_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (source);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_keyring_load_finish (SEAHORSE_PLACE (self), result, &error))
+		g_simple_async_result_take_error (res, error);
+	else if (closure->stamp)
+		keyring_write_cache (self, closure->stamp);
+
+	g_simple_async_result_complete (res);
+	g_object_unref (res);
+}
+
+static void
+on_keyring_refresh_listed (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (user_data);
+	keyring_refresh_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (source);
+	GHashTableIter iter;
+	GError *error = NULL;
+	const gchar *keyid;
+
+	if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result), &error)) {
+		g_simple_async_result_take_error (res, error);
+		g_simple_async_result_complete (res);
+		g_object_unref (res);
+		return;
+	}
+
+	/* Keys that are gone completely */
+	g_hash_table_iter_init (&iter, closure->digests);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, NULL))
+		remove_key (self, keyid);
+
+	/* Keys that lost their secret part come back as public keys */
+	g_hash_table_iter_init (&iter, closure->secrets);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, NULL)) {
+		remove_key (self, keyid);
+		g_ptr_array_add (closure->changed, g_strdup (keyid));
+	}
+
+	g_debug ("refresh found %u changed keys", closure->changed->len);
+
+	if (closure->changed->len == 0) {
+		if (closure->stamp)
+			keyring_write_cache (self, closure->stamp);
+		g_simple_async_result_complete (res);
+		g_object_unref (res);
+		return;
+	}
+
+	/* List only the changed keys again */
+	g_ptr_array_add (closure->changed, NULL);
+	seahorse_gpgme_keyring_load_full_async (self, (const gchar **)closure->changed->pdata,
+	                                        0, closure->cancellable,
+	                                        on_keyring_refresh_loaded, res);
+}
+
+/*
+ * Refreshes the keyring by only listing the keys that changed. Works out
+ * which those are by comparing digests of the listed keys in a thread.
+ */
+static void
+seahorse_gpgme_keyring_refresh_async (SeahorseGpgmeKeyring *self,
+                                      GCancellable *cancellable,
+                                      GAsyncReadyCallback callback,
+                                      gpointer user_data)
+{
+	keyring_refresh_closure *closure;
+	GSimpleAsyncResult *listing;
+	GSimpleAsyncResult *res;
+	SeahorseObject *object;
+	gpgme_error_t gerr = 0;
+	GHashTableIter iter;
+	GError *error = NULL;
+	const gchar *keyid;
+	const gchar *digest;
+
+	schedule_dummy_refresh (self);
+
+	res = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+	                                 seahorse_gpgme_keyring_refresh_async);
+	closure = g_new0 (keyring_refresh_closure, 1);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	closure->gctx = seahorse_gpgme_keyring_new_context (&gerr);
+	closure->stamp = seahorse_gpgme_cache_stamp ();
+	closure->changed = g_ptr_array_new_with_free_func (g_free);
+	closure->digests = g_hash_table_new_full (seahorse_pgp_keyid_hash,
+	                                          seahorse_pgp_keyid_equal,
+	                                          g_free, g_free);
+	closure->secrets = g_hash_table_new_full (seahorse_pgp_keyid_hash,
+	                                          seahorse_pgp_keyid_equal,
+	                                          g_free, NULL);
+	g_simple_async_result_set_op_res_gpointer (res, closure, keyring_refresh_free);
+
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		g_simple_async_result_take_error (res, error);
+		g_simple_async_result_complete_in_idle (res);
+		g_object_unref (res);
+		return;
+	}
+
+	/* Nothing to list if the keyring files are as we last listed them */
+	if (closure->stamp && self->pv->stamp &&
+	    g_bytes_equal (closure->stamp, self->pv->stamp)) {
+		g_debug ("keyring files unchanged, skipping refresh");
+		g_simple_async_result_complete_in_idle (res);
+		g_object_unref (res);
+		return;
+	}
+
+	/* The thread has its own copy of what we know */
+	gpgme_set_passphrase_cb (closure->gctx, NULL, NULL);
+	g_hash_table_iter_init (&iter, self->pv->digests);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, (gpointer *)&digest))
+		g_hash_table_insert (closure->digests, g_strdup (keyid), g_strdup (digest));
+	g_hash_table_iter_init (&iter, self->pv->keys);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&keyid, (gpointer *)&object)) {
+		if (seahorse_object_get_usage (object) == SEAHORSE_USAGE_PRIVATE_KEY)
+			g_hash_table_add (closure->secrets, g_strdup (keyid));
+	}
+
+	listing = g_simple_async_result_new (G_OBJECT (self), on_keyring_refresh_listed, res,
+	                                     seahorse_gpgme_keyring_refresh_async);
+	g_simple_async_result_set_op_res_gpointer (listing, closure, NULL);
+	g_simple_async_result_run_in_thread (listing, keyring_refresh_thread,
+	                                     G_PRIORITY_LOW, cancellable);
+	g_object_unref (listing);
+}
+
+static gboolean
+seahorse_gpgme_keyring_refresh_finish (SeahorseGpgmeKeyring *self,
+                                       GAsyncResult *result,
+                                       GError **error)
+{
+	g_return_val_if_fail (g_simple_async_result_is_valid (result, G_OBJECT (self),
+	                      seahorse_gpgme_keyring_refresh_async), FALSE);
+
+	if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result), error))
+		return FALSE;
+
+	return TRUE;
+}
+
+static void
+on_scheduled_refresh_complete (GObject *source,
+                               GAsyncResult *result,
+                               gpointer user_data)
+{
+	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (source);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_keyring_refresh_finish (self, result, &error)) {
+		g_message ("couldn't refresh keys: %s", error->message);
+		g_clear_error (&error);
+	}
+
+	self->pv->refreshing = FALSE;
+
+	/* Changes came in while we were busy */
+	if (self->pv->refresh_again) {
+		g_debug ("scheduling refresh event due to changes during refresh");
+		self->pv->refresh_again = FALSE;
+		schedule_refresh (self);
+	}
+
+	g_object_unref (self);
+}
+
 static gboolean
 scheduled_refresh (gpointer user_data)
 {
@@ -735,11 +1289,26 @@ scheduled_refresh (gpointer user_data)
 
 	g_debug ("scheduled refresh event ocurring now");
 	cancel_scheduled_refresh (self);
-	seahorse_gpgme_keyring_load_async (SEAHORSE_PLACE (self), NULL, NULL, NULL);
+
+	/* Only list what changed, once we know what we have */
+	if (g_hash_table_size (self->pv->digests) > 0) {
+		self->pv->refreshing = TRUE;
+		seahorse_gpgme_keyring_refresh_async (self, NULL, on_scheduled_refresh_complete,
+		                                      g_object_ref (self));
+	} else {
+		seahorse_gpgme_keyring_load_async (SEAHORSE_PLACE (self), NULL, NULL, NULL);
+	}
 
 	return FALSE; /* don't run again */
 }
 
+static gboolean
+is_keyring_file (const gchar *name)
+{
+	return g_str_has_suffix (name, ".gpg") ||
+	       g_str_has_suffix (name, ".kbx");
+}
+
 static void
 monitor_gpg_homedir (GFileMonitor *handle, GFile *file, GFile *other_file,
                      GFileMonitorEvent event_type, gpointer user_data)
@@ -752,12 +1321,16 @@ monitor_gpg_homedir (GFileMonitor *handle, GFile *file, GFile *other_file,
 	    event_type == G_FILE_MONITOR_EVENT_CREATED) {
 
 		name = g_file_get_basename (file);
-		if (g_str_has_suffix (name, ".gpg")) {
-			if (self->pv->scheduled_refresh == 0) {
+		/* Changes coalesce into a pending refresh, or wait out a dummy */
+		if (is_keyring_file (name)) {
+			if (self->pv->blocked) {
+				self->pv->changed_while_blocked = TRUE;
+			} else if (self->pv->scheduled_refresh == 0) {
 				g_debug ("scheduling refresh event due to file changes");
-				self->pv->scheduled_refresh = g_timeout_add (500, scheduled_refresh, self);
+				schedule_refresh (self);
 			}
 		}
+		g_free (name);
 	}
 }
 
@@ -774,6 +1347,9 @@ seahorse_gpgme_keyring_init (SeahorseGpgmeKeyring *self)
 	self->pv->keys = g_hash_table_new_full (seahorse_pgp_keyid_hash,
 	                                        seahorse_pgp_keyid_equal,
 	                                        g_free, g_object_unref);
+	self->pv->digests = g_hash_table_new_full (seahorse_pgp_keyid_hash,
+	                                           seahorse_pgp_keyid_equal,
+	                                           g_free, g_free);
 
 	/* init private vars */
 	self->pv = G_TYPE_INSTANCE_GET_PRIVATE (self, SEAHORSE_TYPE_GPGME_KEYRING,
@@ -867,11 +1443,11 @@ static void
 seahorse_gpgme_keyring_dispose (GObject *object)
 {
 	SeahorseGpgmeKeyring *self = SEAHORSE_GPGME_KEYRING (object);
-	GList *l;
 
 	if (self->pv->actions)
 		gtk_action_group_set_sensitive (self->pv->actions, TRUE);
 	g_hash_table_remove_all (self->pv->keys);
+	g_hash_table_remove_all (self->pv->digests);
 
 	cancel_scheduled_refresh (self);
 	if (self->pv->monitor_handle) {
@@ -879,11 +1455,6 @@ seahorse_gpgme_keyring_dispose (GObject *object)
 		self->pv->monitor_handle = NULL;
 	}
 
-	for (l = self->pv->orphan_secret; l != NULL; l = g_list_next (l))
-		g_object_unref (l->data);
-	g_list_free (self->pv->orphan_secret);
-	self->pv->orphan_secret = NULL;
-
 	G_OBJECT_CLASS (seahorse_gpgme_keyring_parent_class)->dispose (object);
 }
 
@@ -894,6 +1465,9 @@ seahorse_gpgme_keyring_finalize (GObject *object)
 
 	g_clear_object (&self->pv->actions);
 	g_hash_table_destroy (self->pv->keys);
+	g_hash_table_destroy (self->pv->digests);
+	if (self->pv->stamp)
+		g_bytes_unref (self->pv->stamp);
 
 	/* All monitoring and scheduling should be done */
 	g_assert (self->pv->scheduled_refresh == 0);
@@ -1016,3 +1590,43 @@ seahorse_gpgme_keyring_new_context (gpgme_error_t *gerr)
 		*gerr = 0;
 	return ctx;
 }
+
+/* Listing contexts kept around for reuse, only used from the main thread */
+static GQueue context_pool = G_QUEUE_INIT;
+
+/**
+ * seahorse_gpgme_keyring_acquire_context
+ * @gerr: Location to place an error
+ *
+ * Gets a context for listing keys, reusing a pooled one if possible.
+ * Return it with seahorse_gpgme_keyring_release_context().
+ *
+ * Returns: The context, or NULL on failure
+ **/
+gpgme_ctx_t
+seahorse_gpgme_keyring_acquire_context (gpgme_error_t *gerr)
+{
+	gpgme_ctx_t ctx;
+
+	ctx = g_queue_pop_head (&context_pool);
+	if (ctx == NULL)
+		return seahorse_gpgme_keyring_new_context (gerr);
+
+	if (gerr)
+		*gerr = 0;
+	return ctx;
+}
+
+void
+seahorse_gpgme_keyring_release_context (gpgme_ctx_t ctx)
+{
+	if (ctx == NULL)
+		return;
+
+	if (g_queue_get_length (&context_pool) < MAX_POOLED_CONTEXTS) {
+		gpgme_set_keylist_mode (ctx, GPGME_KEYLIST_MODE_LOCAL);
+		g_queue_push_head (&context_pool, ctx);
+	} else {
+		gpgme_release (ctx);
+	}
+}
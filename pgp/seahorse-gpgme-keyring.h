@@ -70,6 +70,10 @@ SeahorseGpgmeKeyring * seahorse_gpgme_keyring_new            (void);
 
 gpgme_ctx_t            seahorse_gpgme_keyring_new_context    (gpgme_error_t *gerr);
 
+gpgme_ctx_t            seahorse_gpgme_keyring_acquire_context (gpgme_error_t *gerr);
+
+void                   seahorse_gpgme_keyring_release_context (gpgme_ctx_t ctx);
+
 SeahorseGpgmeKey *     seahorse_gpgme_keyring_lookup         (SeahorseGpgmeKeyring *self,
                                                               const gchar *keyid);
 
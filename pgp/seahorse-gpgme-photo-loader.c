@@ -0,0 +1,374 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "seahorse-gpgme.h"
+#include "seahorse-gpgme-keyring.h"
+#include "seahorse-gpgme-photo.h"
+#include "seahorse-gpgme-photo-loader.h"
+#include "seahorse-pgp-packets.h"
+
+#include <gtk/gtk.h>
+
+#include <glib/gi18n.h>
+
+/* Amount of keys whose photos are kept around */
+#define MAX_CACHED_KEYS 64
+
+typedef struct {
+	guint index;
+	GdkPixbuf *pixbuf;
+} PhotoEntry;
+
+typedef struct {
+	gchar *fingerprint;
+	GArray *photos;
+	GList *link;
+} CachedPhotos;
+
+/* Both only used from the main thread, most recently used at the head */
+static GHashTable *photo_cache = NULL;
+static GQueue photo_cache_lru = G_QUEUE_INIT;
+
+static void
+clear_photo_entry (gpointer data)
+{
+	PhotoEntry *entry = data;
+	g_clear_object (&entry->pixbuf);
+}
+
+static GArray *
+photo_entries_new (void)
+{
+	GArray *photos;
+
+	photos = g_array_new (FALSE, TRUE, sizeof (PhotoEntry));
+	g_array_set_clear_func (photos, clear_photo_entry);
+	return photos;
+}
+
+static void
+cached_photos_free (gpointer data)
+{
+	CachedPhotos *cached = data;
+	g_queue_delete_link (&photo_cache_lru, cached->link);
+	g_array_unref (cached->photos);
+	g_free (cached->fingerprint);
+	g_free (cached);
+}
+
+static void
+photo_cache_insert (const gchar *fingerprint,
+                    GArray *photos)
+{
+	CachedPhotos *cached;
+
+	if (photo_cache == NULL)
+		photo_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+		                                     NULL, cached_photos_free);
+
+	g_hash_table_remove (photo_cache, fingerprint);
+
+	cached = g_new0 (CachedPhotos, 1);
+	cached->fingerprint = g_strdup (fingerprint);
+	cached->photos = g_array_ref (photos);
+	g_queue_push_head (&photo_cache_lru, cached);
+	cached->link = photo_cache_lru.head;
+	g_hash_table_insert (photo_cache, cached->fingerprint, cached);
+
+	while (g_queue_get_length (&photo_cache_lru) > MAX_CACHED_KEYS) {
+		cached = g_queue_peek_tail (&photo_cache_lru);
+		g_hash_table_remove (photo_cache, cached->fingerprint);
+	}
+}
+
+static GList *
+photos_for_key (gpgme_key_t pubkey,
+                GArray *photos)
+{
+	GList *results = NULL;
+	PhotoEntry *entry;
+	GdkPixbuf *pixbuf;
+	guint i;
+
+	for (i = 0; i < photos->len; i++) {
+		entry = &g_array_index (photos, PhotoEntry, i);
+
+		/* Load a 'missing' icon for images that couldn't be decoded */
+		if (entry->pixbuf)
+			pixbuf = g_object_ref (entry->pixbuf);
+		else
+			pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
+			                                   "gnome-unknown", 48, 0, NULL);
+
+		results = g_list_prepend (results, seahorse_gpgme_photo_new (pubkey, pixbuf, entry->index));
+		if (pixbuf)
+			g_object_unref (pixbuf);
+	}
+
+	return g_list_reverse (results);
+}
+
+/**
+ * seahorse_gpgme_photo_loader_lookup:
+ * @key: The key
+ * @photos: Filled in with a list of #SeahorseGpgmePhoto
+ *
+ * Looks for the photos of @key in the cache. Free @photos with
+ * seahorse_object_list_free().
+ *
+ * Returns: Whether the photos of @key were cached.
+ **/
+gboolean
+seahorse_gpgme_photo_loader_lookup (SeahorseGpgmeKey *key,
+                                    GList **photos)
+{
+	CachedPhotos *cached = NULL;
+	const gchar *fingerprint;
+	gpgme_key_t pubkey;
+
+	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (key), FALSE);
+	g_return_val_if_fail (photos != NULL, FALSE);
+
+	fingerprint = seahorse_pgp_key_get_fingerprint (SEAHORSE_PGP_KEY (key));
+	if (photo_cache && fingerprint)
+		cached = g_hash_table_lookup (photo_cache, fingerprint);
+	if (cached == NULL)
+		return FALSE;
+
+	pubkey = seahorse_gpgme_key_get_public (key);
+	if (pubkey == NULL)
+		return FALSE;
+
+	/* Most recently used */
+	g_queue_unlink (&photo_cache_lru, cached->link);
+	g_queue_push_head_link (&photo_cache_lru, cached->link);
+
+	*photos = photos_for_key (pubkey, cached->photos);
+	return TRUE;
+}
+
+/**
+ * seahorse_gpgme_photo_loader_forget:
+ * @key: The key
+ *
+ * Drops the cached photos of @key, for example when it has changed.
+ **/
+void
+seahorse_gpgme_photo_loader_forget (SeahorseGpgmeKey *key)
+{
+	const gchar *fingerprint;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (key));
+
+	fingerprint = seahorse_pgp_key_get_fingerprint (SEAHORSE_PGP_KEY (key));
+	if (photo_cache && fingerprint)
+		g_hash_table_remove (photo_cache, fingerprint);
+}
+
+typedef struct {
+	gchar *fingerprint;
+	gpgme_key_t pubkey;
+	GArray *photos;
+} photo_load_closure;
+
+static void
+photo_load_free (gpointer data)
+{
+	photo_load_closure *closure = data;
+	g_free (closure->fingerprint);
+	gpgme_key_unref (closure->pubkey);
+	if (closure->photos)
+		g_array_unref (closure->photos);
+	g_free (closure);
+}
+
+static GdkPixbuf *
+decode_photo (const guchar *image,
+              gsize n_image)
+{
+	GdkPixbufLoader *loader;
+	GdkPixbuf *pixbuf = NULL;
+	GError *error = NULL;
+
+	loader = gdk_pixbuf_loader_new ();
+	if (gdk_pixbuf_loader_write (loader, image, n_image, &error) &&
+	    gdk_pixbuf_loader_close (loader, &error)) {
+		pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
+		if (pixbuf)
+			g_object_ref (pixbuf);
+	} else {
+		g_warning ("couldn't decode photo: %s", error->message);
+		g_error_free (error);
+		gdk_pixbuf_loader_close (loader, NULL);
+	}
+
+	g_object_unref (loader);
+	return pixbuf;
+}
+
+static void
+photo_load_thread (GSimpleAsyncResult *res,
+                   GObject *object,
+                   GCancellable *cancellable)
+{
+	photo_load_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	SeahorsePgpPacket packet;
+	const guchar *image;
+	const guchar *at;
+	GError *error = NULL;
+	gpgme_error_t gerr;
+	gpgme_data_t data = NULL;
+	gpgme_ctx_t gctx;
+	PhotoEntry entry;
+	gboolean in_key = FALSE;
+	guint index = 0;
+	gsize n_image;
+	gsize n_at;
+	gchar *buf;
+	size_t n_buf;
+
+	gctx = seahorse_gpgme_keyring_new_context (&gerr);
+	if (gctx != NULL) {
+		/* No prompting from this thread */
+		gpgme_set_passphrase_cb (gctx, NULL, NULL);
+		gerr = gpgme_data_new (&data);
+	}
+	if (GPG_IS_OK (gerr))
+		gerr = gpgme_op_export (gctx, closure->fingerprint, 0, data);
+
+	if (seahorse_gpgme_propagate_error (gerr, &error)) {
+		g_simple_async_result_take_error (res, error);
+		if (data)
+			gpgme_data_release (data);
+		if (gctx)
+			gpgme_release (gctx);
+		return;
+	}
+
+	buf = gpgme_data_release_and_get_mem (data, &n_buf);
+	gpgme_release (gctx);
+
+	closure->photos = photo_entries_new ();
+	at = (const guchar *)buf;
+	n_at = buf ? n_buf : 0;
+
+	/* The uid numbers count user IDs and user attributes together, from one */
+	while (seahorse_pgp_packet_next (&at, &n_at, &packet)) {
+		if (g_cancellable_is_cancelled (cancellable))
+			break;
+
+		if (packet.tag == SEAHORSE_PGP_PACKET_PUBLIC_KEY) {
+			if (in_key)
+				break;
+			in_key = TRUE;
+
+		} else if (packet.tag == SEAHORSE_PGP_PACKET_USER_ID) {
+			index++;
+
+		} else if (packet.tag == SEAHORSE_PGP_PACKET_USER_ATTRIBUTE) {
+			index++;
+			entry.index = index;
+			entry.pixbuf = NULL;
+			if (seahorse_pgp_packet_get_image (&packet, &image, &n_image))
+				entry.pixbuf = decode_photo (image, n_image);
+			g_array_append_val (closure->photos, entry);
+		}
+	}
+
+	gpgme_free (buf);
+
+	g_cancellable_set_error_if_cancelled (cancellable, &error);
+	if (error != NULL)
+		g_simple_async_result_take_error (res, error);
+}
+
+/**
+ * seahorse_gpgme_photo_loader_load_async:
+ * @key: The key
+ * @cancellable: Optional cancellation object
+ * @callback: Called when the operation completes
+ * @user_data: Data for @callback
+ *
+ * Loads the photos of @key on a worker thread, and adds them to the cache.
+ **/
+void
+seahorse_gpgme_photo_loader_load_async (SeahorseGpgmeKey *key,
+                                        GCancellable *cancellable,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+	photo_load_closure *closure;
+	GSimpleAsyncResult *res;
+	const gchar *fingerprint;
+	gpgme_key_t pubkey;
+
+	g_return_if_fail (SEAHORSE_IS_GPGME_KEY (key));
+
+	res = g_simple_async_result_new (G_OBJECT (key), callback, user_data,
+	                                 seahorse_gpgme_photo_loader_load_async);
+
+	pubkey = seahorse_gpgme_key_get_public (key);
+	fingerprint = seahorse_pgp_key_get_fingerprint (SEAHORSE_PGP_KEY (key));
+	if (pubkey == NULL || fingerprint == NULL || !fingerprint[0]) {
+		g_simple_async_result_set_error (res, SEAHORSE_GPGME_ERROR, GPG_ERR_INV_VALUE,
+		                                 _("The key could not be loaded"));
+		g_simple_async_result_complete_in_idle (res);
+		g_object_unref (res);
+		return;
+	}
+
+	closure = g_new0 (photo_load_closure, 1);
+	closure->fingerprint = g_strdup (fingerprint);
+	closure->pubkey = pubkey;
+	gpgme_key_ref (pubkey);
+	g_simple_async_result_set_op_res_gpointer (res, closure, photo_load_free);
+
+	g_simple_async_result_run_in_thread (res, photo_load_thread,
+	                                     G_PRIORITY_LOW, cancellable);
+	g_object_unref (res);
+}
+
+/**
+ * seahorse_gpgme_photo_loader_load_finish:
+ * @key: The key
+ * @result: The asynchronous result
+ * @error: Location to place an error
+ *
+ * Free the result with seahorse_object_list_free().
+ *
+ * Returns: (transfer full): A list of #SeahorseGpgmePhoto, or NULL on
+ *          failure or if the key has no photos.
+ **/
+GList *
+seahorse_gpgme_photo_loader_load_finish (SeahorseGpgmeKey *key,
+                                         GAsyncResult *result,
+                                         GError **error)
+{
+	photo_load_closure *closure;
+
+	g_return_val_if_fail (g_simple_async_result_is_valid (result, G_OBJECT (key),
+	                      seahorse_gpgme_photo_loader_load_async), NULL);
+
+	if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result), error))
+		return NULL;
+
+	closure = g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (result));
+	photo_cache_insert (closure->fingerprint, closure->photos);
+	return photos_for_key (closure->pubkey, closure->photos);
+}
@@ -0,0 +1,48 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Loads the photo IDs of a key without running gpg --edit-key.
+ *
+ * - The key is exported and its user attribute packets are decoded on a
+ *   worker thread.
+ * - Decoded photos are kept in a small LRU cache shared by all windows,
+ *   keyed by fingerprint.
+ */
+
+#ifndef __SEAHORSE_GPGME_PHOTO_LOADER_H__
+#define __SEAHORSE_GPGME_PHOTO_LOADER_H__
+
+#include <gio/gio.h>
+
+#include "pgp/seahorse-gpgme-key.h"
+
+gboolean        seahorse_gpgme_photo_loader_lookup       (SeahorseGpgmeKey *key,
+                                                          GList **photos);
+
+void            seahorse_gpgme_photo_loader_load_async   (SeahorseGpgmeKey *key,
+                                                          GCancellable *cancellable,
+                                                          GAsyncReadyCallback callback,
+                                                          gpointer user_data);
+
+GList *         seahorse_gpgme_photo_loader_load_finish  (SeahorseGpgmeKey *key,
+                                                          GAsyncResult *result,
+                                                          GError **error);
+
+void            seahorse_gpgme_photo_loader_forget       (SeahorseGpgmeKey *key);
+
+#endif /* __SEAHORSE_GPGME_PHOTO_LOADER_H__ */
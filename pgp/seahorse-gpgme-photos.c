@@ -244,6 +244,34 @@ add_image_files (GtkWidget *dialog)
 }   
 
 
+static void
+on_photo_add_complete (GObject *source,
+                       GAsyncResult *result,
+                       gpointer user_data)
+{
+	gchar *tempfile = user_data;
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_photo_add_finish (SEAHORSE_GPGME_KEY (source), result, &error)) {
+
+		/* A special error value set by seahorse_key_op_photoid_add to
+		   denote an invalid format file */
+		if (g_error_matches (error, SEAHORSE_GPGME_ERROR, GPG_ERR_USER_1)) {
+			seahorse_util_show_error (NULL, _("Couldn't add photo"),
+			                          _("The file could not be loaded. It may be in an invalid format"));
+			g_clear_error (&error);
+		} else {
+			seahorse_util_handle_error (&error, NULL, _("Couldn't add photo"));
+		}
+	}
+
+	/* gpg is done reading the resized copy */
+	if (tempfile) {
+		unlink (tempfile);
+		g_free (tempfile);
+	}
+}
+
 gboolean
 seahorse_gpgme_photo_add (SeahorseGpgmeKey *pkey,
                           GtkWindow *parent,
@@ -252,9 +280,7 @@ seahorse_gpgme_photo_add (SeahorseGpgmeKey *pkey,
 	gchar *filename = NULL;
 	gchar *tempfile = NULL;
 	GError *error = NULL;
-	gpgme_error_t gerr;
 	GtkWidget *chooser;
-	gboolean res = TRUE;
 
 	g_return_val_if_fail (SEAHORSE_IS_GPGME_KEY (pkey), FALSE);
 
@@ -282,35 +308,32 @@ seahorse_gpgme_photo_add (SeahorseGpgmeKey *pkey,
 
 	if (!prepare_photo_id (parent, filename, &tempfile, &error)) {
 		seahorse_util_handle_error (&error, NULL, _("Couldn't prepare photo"));
+		g_free (filename);
 		return FALSE;
 	}
 
-	gerr = seahorse_gpgme_key_op_photo_add (pkey, tempfile ? tempfile : filename);
-	if (!GPG_IS_OK (gerr)) {
-
-		/* A special error value set by seahorse_key_op_photoid_add to
-		   denote an invalid format file */
-		if (gerr == GPG_E (GPG_ERR_USER_1))
-			seahorse_util_show_error (NULL, _("Couldn't add photo"),
-			                          _("The file could not be loaded. It may be in an invalid format"));
-		else
-			seahorse_gpgme_handle_error (gerr, _("Couldn't add photo"));
-		res = FALSE;
-	}
+	/* Failures are reported when gpg is done */
+	seahorse_gpgme_key_op_photo_add_async (pkey, tempfile ? tempfile : filename, NULL,
+	                                       on_photo_add_complete, tempfile);
 
 	g_free (filename);
-	if (tempfile) {
-		unlink (tempfile);
-		g_free (tempfile);
-	}
+	return TRUE;
+}
+
+static void
+on_photo_delete_complete (GObject *source,
+                          GAsyncResult *result,
+                          gpointer user_data)
+{
+	GError *error = NULL;
 
-	return res;
+	if (!seahorse_gpgme_key_op_photo_delete_finish (SEAHORSE_GPGME_PHOTO (source), result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't delete photo"));
 }
 
 gboolean
 seahorse_gpgme_photo_delete (SeahorseGpgmePhoto *photo, GtkWindow *parent)
 {
-    gpgme_error_t gerr;
     GtkWidget *dlg;
     gint response; 
 
@@ -329,11 +352,6 @@ seahorse_gpgme_photo_delete (SeahorseGpgmePhoto *photo, GtkWindow *parent)
     if (response != GTK_RESPONSE_ACCEPT)
         return FALSE;
     
-    gerr = seahorse_gpgme_key_op_photo_delete (photo);
-    if (!GPG_IS_OK (gerr)) {
-	    seahorse_gpgme_handle_error (gerr, _("Couldn't delete photo"));
-        return FALSE;
-    }
-    
+    seahorse_gpgme_key_op_photo_delete_async (photo, NULL, on_photo_delete_complete, NULL);
     return TRUE;
 }
@@ -41,6 +41,18 @@ enum {
 void               on_gpgme_revoke_ok_clicked               (GtkButton *button,
                                                              gpointer user_data);
 
+static void
+on_revoke_subkey_complete (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_revoke_subkey_finish (SEAHORSE_GPGME_SUBKEY (source),
+	                                                 result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't revoke subkey"));
+}
+
 G_MODULE_EXPORT void
 on_gpgme_revoke_ok_clicked (GtkButton *button,
                             gpointer user_data)
@@ -49,7 +61,6 @@ on_gpgme_revoke_ok_clicked (GtkButton *button,
 	SeahorseRevokeReason reason;
 	SeahorseGpgmeSubkey *subkey;
 	const gchar *description;
-	gpgme_error_t err;
 	GtkWidget *widget;
 	GtkTreeModel *model;
 	GtkTreeIter iter;
@@ -68,9 +79,8 @@ on_gpgme_revoke_ok_clicked (GtkButton *button,
 	subkey = g_object_get_data (G_OBJECT (swidget), "subkey");
 	g_return_if_fail (SEAHORSE_IS_GPGME_SUBKEY (subkey));
 	
-	err = seahorse_gpgme_key_op_revoke_subkey (subkey, reason, description);
-	if (!GPG_IS_OK (err))
-		seahorse_gpgme_handle_error (err, _("Couldn't revoke subkey"));
+	seahorse_gpgme_key_op_revoke_subkey_async (subkey, reason, description, NULL,
+	                                           on_revoke_subkey_complete, NULL);
 	seahorse_widget_destroy (swidget);
 }
 
@@ -141,13 +151,24 @@ seahorse_gpgme_revoke_new (SeahorseGpgmeSubkey *subkey, GtkWindow *parent)
 	                                NULL);
 }
 
+static void
+on_add_revoker_complete (GObject *source,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_add_revoker_finish (SEAHORSE_GPGME_KEY (source),
+	                                               result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't add revoker"));
+}
+
 void
 seahorse_gpgme_add_revoker_new (SeahorseGpgmeKey *pkey, GtkWindow *parent)
 {
 	SeahorseGpgmeKey *revoker;
 	GtkWidget *dialog;
 	gint response;
-	gpgme_error_t err;
 	const gchar *userid1, *userid2;
 	
 	g_return_if_fail (pkey != NULL && SEAHORSE_IS_GPGME_KEY (pkey));
@@ -171,7 +192,6 @@ seahorse_gpgme_add_revoker_new (SeahorseGpgmeKey *pkey, GtkWindow *parent)
 	if (response != GTK_RESPONSE_YES)
 		return;
 	
-	err = seahorse_gpgme_key_op_add_revoker (pkey, revoker);
-	if (!GPG_IS_OK (err))
-		seahorse_gpgme_handle_error (err, _("Couldn't add revoker"));
+	seahorse_gpgme_key_op_add_revoker_async (pkey, revoker, NULL,
+	                                         on_add_revoker_complete, NULL);
 }
@@ -35,6 +35,32 @@
 void              on_gpgme_sign_choice_toggled         (GtkToggleButton *toggle,
                                                         gpointer user_data);
 
+static void
+on_sign_complete (GObject *source,
+                  GAsyncResult *result,
+                  gpointer user_data)
+{
+	GtkWindow *parent = user_data;
+	GError *error = NULL;
+	GtkWidget *w;
+
+	if (!seahorse_gpgme_key_op_sign_multiple_finish (SEAHORSE_GPGME_KEY (source), result, &error)) {
+		if (g_error_matches (error, SEAHORSE_GPGME_ERROR, GPG_ERR_EALREADY)) {
+			w = gtk_message_dialog_new (parent, GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_CLOSE,
+			                            _("This key was already signed by\n\"%s\""),
+			                            seahorse_object_get_label (SEAHORSE_OBJECT (source)));
+			gtk_dialog_run (GTK_DIALOG (w));
+			gtk_widget_destroy (w);
+			g_clear_error (&error);
+		} else {
+			seahorse_util_handle_error (&error, parent, _("Couldn't sign key"));
+		}
+	}
+
+	if (parent)
+		g_object_unref (parent);
+}
+
 static gboolean
 sign_ok_clicked (SeahorseWidget *swidget, GtkWindow *parent)
 {
@@ -42,8 +68,8 @@ sign_ok_clicked (SeahorseWidget *swidget, GtkWindow *parent)
     SeahorseSignOptions options = 0;
     SeahorsePgpKey *signer;
     GtkWidget *w;
-    gpgme_error_t err;
     SeahorseObject *to_sign;
+    GList *objects;
     
     /* Figure out choice */
     check = SIGN_CHECK_NO_ANSWER;
@@ -85,24 +111,14 @@ sign_ok_clicked (SeahorseWidget *swidget, GtkWindow *parent)
                           seahorse_object_get_usage (SEAHORSE_OBJECT (signer)) == SEAHORSE_USAGE_PRIVATE_KEY));
     
     to_sign = g_object_get_data (G_OBJECT (swidget), "to-sign");
-    if (SEAHORSE_IS_GPGME_UID (to_sign))
-	    err = seahorse_gpgme_key_op_sign_uid (SEAHORSE_GPGME_UID (to_sign), SEAHORSE_GPGME_KEY (signer), check, options);
-    else if (SEAHORSE_IS_GPGME_KEY (to_sign))
-	    err = seahorse_gpgme_key_op_sign (SEAHORSE_GPGME_KEY (to_sign), SEAHORSE_GPGME_KEY (signer), check, options);
-    else
-	    g_assert (FALSE);
-    
+    g_assert (SEAHORSE_IS_GPGME_UID (to_sign) || SEAHORSE_IS_GPGME_KEY (to_sign));
 
-    if (!GPG_IS_OK (err)) {
-        if (gpgme_err_code (err) == GPG_ERR_EALREADY) {
-            w = gtk_message_dialog_new (parent, GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_CLOSE,
-                                        _("This key was already signed by\n\"%s\""),
-                                        seahorse_object_get_label (SEAHORSE_OBJECT (signer)));
-            gtk_dialog_run (GTK_DIALOG (w));
-            gtk_widget_destroy (w);
-        } else
-            seahorse_gpgme_handle_error (err, _("Couldn't sign key"));
-    }
+    /* Errors are reported once gpg is done */
+    objects = g_list_prepend (NULL, to_sign);
+    seahorse_gpgme_key_op_sign_multiple_async (objects, SEAHORSE_GPGME_KEY (signer),
+                                               check, options, NULL, on_sign_complete,
+                                               parent ? g_object_ref (parent) : NULL);
+    g_list_free (objects);
 
     seahorse_widget_destroy (swidget);
     
@@ -301,23 +301,50 @@ on_pgp_names_add_clicked (GtkWidget *widget,
 	                            GTK_WINDOW (seahorse_widget_get_widget (swidget, swidget->name)));
 }
 
+static void
+on_primary_uid_complete (GObject *source,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_primary_uid_finish (SEAHORSE_GPGME_UID (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Couldn't change primary user ID"));
+
+	g_object_unref (parent);
+}
+
 G_MODULE_EXPORT void
 on_pgp_names_primary_clicked (GtkWidget *widget,
                               gpointer user_data)
 {
 	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
 	SeahorsePgpUid *uid;
-	gpgme_error_t err;
     
 	uid = names_get_selected_uid (swidget);
 	if (uid) {
 		g_return_if_fail (SEAHORSE_IS_GPGME_UID (uid));
-		err = seahorse_gpgme_key_op_primary_uid (SEAHORSE_GPGME_UID (uid));
-		if (!GPG_IS_OK (err)) 
-			seahorse_gpgme_handle_error (err, _("Couldn't change primary user ID"));
+		seahorse_gpgme_key_op_primary_uid_async (SEAHORSE_GPGME_UID (uid), NULL,
+		                                         on_primary_uid_complete,
+		                                         g_object_ref (seahorse_widget_get_toplevel (swidget)));
 	}
 }
 
+static void
+on_del_uid_complete (GObject *source,
+                     GAsyncResult *result,
+                     gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_del_uid_finish (SEAHORSE_GPGME_UID (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Couldn't delete user ID"));
+
+	g_object_unref (parent);
+}
+
 G_MODULE_EXPORT void
 on_pgp_names_delete_clicked (GtkWidget *widget,
                              gpointer user_data)
@@ -326,7 +353,6 @@ on_pgp_names_delete_clicked (GtkWidget *widget,
 	SeahorsePgpUid *uid;
 	gboolean ret;
 	gchar *message; 
-	gpgme_error_t gerr;
     
 	uid = names_get_selected_uid (swidget);
 	if (uid == NULL)
@@ -341,9 +367,9 @@ on_pgp_names_delete_clicked (GtkWidget *widget,
 	if (ret == FALSE)
 		return;
 	
-	gerr = seahorse_gpgme_key_op_del_uid (SEAHORSE_GPGME_UID (uid));
-	if (!GPG_IS_OK (gerr))
-		seahorse_gpgme_handle_error (gerr, _("Couldn't delete user ID"));
+	seahorse_gpgme_key_op_del_uid_async (SEAHORSE_GPGME_UID (uid), NULL,
+	                                     on_del_uid_complete,
+	                                     g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 G_MODULE_EXPORT void
@@ -640,6 +666,22 @@ on_pgp_owner_photo_add_button (GtkWidget *widget,
 		g_object_set_data (G_OBJECT (swidget), "current-photoid", NULL);
 }
  
+static void
+on_photo_delete_complete (GObject *source,
+                          GAsyncResult *result,
+                          gpointer user_data)
+{
+	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_photo_delete_finish (SEAHORSE_GPGME_PHOTO (source), result, &error))
+		seahorse_util_handle_error (&error, swidget, _("Couldn't delete photo"));
+	else if (g_object_get_data (G_OBJECT (swidget), "current-photoid") == source)
+		g_object_set_data (G_OBJECT (swidget), "current-photoid", NULL);
+
+	g_object_unref (swidget);
+}
+
 G_MODULE_EXPORT void
 on_pgp_owner_photo_delete_button (GtkWidget *widget,
                                   gpointer user_data)
@@ -650,8 +692,22 @@ on_pgp_owner_photo_delete_button (GtkWidget *widget,
 	photo = g_object_get_data (G_OBJECT (swidget), "current-photoid");
 	g_return_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo));
 
-	if (seahorse_gpgme_key_op_photo_delete (photo))
-		g_object_set_data (G_OBJECT (swidget), "current-photoid", NULL);
+	seahorse_gpgme_key_op_photo_delete_async (photo, NULL, on_photo_delete_complete,
+	                                          g_object_ref (swidget));
+}
+
+static void
+on_photo_primary_complete (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_photo_primary_finish (SEAHORSE_GPGME_PHOTO (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Couldn't change primary photo"));
+
+	g_object_unref (parent);
 }
 
 G_MODULE_EXPORT void
@@ -659,15 +715,13 @@ on_pgp_owner_photo_primary_button (GtkWidget *widget,
                                    gpointer user_data)
 {
 	SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
-	gpgme_error_t gerr;
 	SeahorseGpgmePhoto *photo;
 
 	photo = g_object_get_data (G_OBJECT (swidget), "current-photoid");
 	g_return_if_fail (SEAHORSE_IS_GPGME_PHOTO (photo));
         
-	gerr = seahorse_gpgme_key_op_photo_primary (photo);
-	if (!GPG_IS_OK (gerr))
-		seahorse_gpgme_handle_error (gerr, _("Couldn't change primary photo"));
+	seahorse_gpgme_key_op_photo_primary_async (photo, NULL, on_photo_primary_complete,
+	                                           g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 static void
@@ -832,6 +886,20 @@ static GType uid_columns[] = {
     G_TYPE_STRING   /* comment */
 };
 
+static void
+on_change_pass_complete (GObject *source,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_change_pass_finish (SEAHORSE_GPGME_KEY (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Couldn't change passphrase"));
+
+	g_object_unref (parent);
+}
+
 G_MODULE_EXPORT void
 on_pgp_owner_passphrase_button_clicked (GtkWidget *widget,
                                         gpointer user_data)
@@ -840,7 +908,9 @@ on_pgp_owner_passphrase_button_clicked (GtkWidget *widget,
 	SeahorseObject *object = SEAHORSE_OBJECT (SEAHORSE_OBJECT_WIDGET (swidget)->object);
 	if (seahorse_object_get_usage (object) == SEAHORSE_USAGE_PRIVATE_KEY && 
 	    SEAHORSE_IS_GPGME_KEY (object))
-		seahorse_gpgme_key_op_change_pass (SEAHORSE_GPGME_KEY (object));
+		seahorse_gpgme_key_op_change_pass_async (SEAHORSE_GPGME_KEY (object), NULL,
+		                                         on_change_pass_complete,
+		                                         g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 static void
@@ -1060,6 +1130,20 @@ on_pgp_details_add_subkey_button (GtkButton *button,
 	seahorse_gpgme_add_subkey_new (SEAHORSE_GPGME_KEY (object), GTK_WINDOW (seahorse_widget_get_widget (swidget, swidget->name)));
 }
 
+static void
+on_del_subkey_complete (GObject *source,
+                        GAsyncResult *result,
+                        gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_del_subkey_finish (SEAHORSE_GPGME_SUBKEY (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Couldn't delete subkey"));
+
+	g_object_unref (parent);
+}
+
 G_MODULE_EXPORT void
 on_pgp_details_del_subkey_button (GtkButton *button,
                                   gpointer user_data)
@@ -1071,7 +1155,6 @@ on_pgp_details_del_subkey_button (GtkButton *button,
 	gboolean ret;
 	const gchar *label;
 	gchar *message; 
-	gpgme_error_t err;
 
 	pkey = SEAHORSE_PGP_KEY (SEAHORSE_OBJECT_WIDGET (swidget)->object);
 	subkey = get_selected_subkey (swidget);
@@ -1089,9 +1172,9 @@ on_pgp_details_del_subkey_button (GtkButton *button,
 	if (ret == FALSE)
 		return;
 	
-	err = seahorse_gpgme_key_op_del_subkey (SEAHORSE_GPGME_SUBKEY (subkey));
-	if (!GPG_IS_OK (err))
-		seahorse_gpgme_handle_error (err, _("Couldn't delete subkey"));
+	seahorse_gpgme_key_op_del_subkey_async (SEAHORSE_GPGME_SUBKEY (subkey), NULL,
+	                                        on_del_subkey_complete,
+	                                        g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 G_MODULE_EXPORT void
@@ -1106,6 +1189,20 @@ on_pgp_details_revoke_subkey_button (GtkButton *button,
 	}
 }
 
+static void
+on_set_trust_complete (GObject *source,
+                       GAsyncResult *result,
+                       gpointer user_data)
+{
+	GtkWindow *parent = GTK_WINDOW (user_data);
+	GError *error = NULL;
+
+	if (!seahorse_gpgme_key_op_set_trust_finish (SEAHORSE_GPGME_KEY (source), result, &error))
+		seahorse_util_handle_error (&error, parent, _("Unable to change trust"));
+
+	g_object_unref (parent);
+}
+
 G_MODULE_EXPORT void
 on_pgp_details_trust_changed (GtkComboBox *selection,
                               gpointer user_data)
@@ -1115,7 +1212,6 @@ on_pgp_details_trust_changed (GtkComboBox *selection,
 	gint trust;
 	GtkTreeModel *model;
 	GtkTreeIter iter;
-	gpgme_error_t err;
 	gboolean set;
 	
 	set = gtk_combo_box_get_active_iter (selection, &iter);
@@ -1128,11 +1224,10 @@ on_pgp_details_trust_changed (GtkComboBox *selection,
 	model = gtk_combo_box_get_model (selection);
 	gtk_tree_model_get (model, &iter, TRUST_VALIDITY, &trust, -1);
                                   
-	if (seahorse_pgp_key_get_trust (SEAHORSE_PGP_KEY (object)) != trust) {
-		err = seahorse_gpgme_key_op_set_trust (SEAHORSE_GPGME_KEY (object), trust);
-		if (err)
-    			seahorse_gpgme_handle_error (err, _("Unable to change trust"));
-	}
+	if (seahorse_pgp_key_get_trust (SEAHORSE_PGP_KEY (object)) != trust)
+		seahorse_gpgme_key_op_set_trust_async (SEAHORSE_GPGME_KEY (object), trust, NULL,
+		                                       on_set_trust_complete,
+		                                       g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 static void
@@ -1536,7 +1631,6 @@ on_pgp_trust_marginal_toggled (GtkToggleButton *toggle,
     SeahorseWidget *swidget = SEAHORSE_WIDGET (user_data);
     GObject *object;
     SeahorseValidity trust;
-    gpgme_error_t err;
 
     object = SEAHORSE_OBJECT_WIDGET (swidget)->object;
     g_return_if_fail (SEAHORSE_IS_GPGME_KEY (object));
@@ -1544,11 +1638,10 @@ on_pgp_trust_marginal_toggled (GtkToggleButton *toggle,
     trust = gtk_toggle_button_get_active (toggle) ?
             SEAHORSE_VALIDITY_MARGINAL : SEAHORSE_VALIDITY_UNKNOWN;
     
-    if (seahorse_pgp_key_get_trust (SEAHORSE_PGP_KEY (object)) != trust) {
-        err = seahorse_gpgme_key_op_set_trust (SEAHORSE_GPGME_KEY (object), trust);
-        if (err)
-        	seahorse_gpgme_handle_error (err, _("Unable to change trust"));
-    }
+    if (seahorse_pgp_key_get_trust (SEAHORSE_PGP_KEY (object)) != trust)
+        seahorse_gpgme_key_op_set_trust_async (SEAHORSE_GPGME_KEY (object), trust, NULL,
+                                               on_set_trust_complete,
+                                               g_object_ref (seahorse_widget_get_toplevel (swidget)));
 }
 
 /* Is called whenever a signature key changes */
@@ -60,6 +60,13 @@ struct _SeahorsePgpKeyPrivate {
 	GList *uids;			/* All the UID objects */
 	GList *subkeys;                 /* All the Subkey objects */
 	GList *photos;                  /* List of photos */
+	guint uids_generation;          /* Changes when the UID list is replaced */
+
+	/* What the label and markup were last built from */
+	gboolean display_built;
+	guint display_flags;
+	guint display_generation;
+	guint display_stamp;
 };
 
 /*
@@ -194,6 +201,17 @@ calc_markup (SeahorsePgpKey *self)
 	return g_string_free (result, FALSE);
 }
 
+static guint
+calc_uids_stamp (SeahorsePgpKey *self)
+{
+	GList *l;
+	guint stamp = 0;
+
+	for (l = seahorse_pgp_key_get_uids (self); l != NULL; l = g_list_next (l))
+		stamp = MAX (stamp, seahorse_pgp_uid_get_text_stamp (l->data));
+	return stamp;
+}
+
 /* -----------------------------------------------------------------------------
  * OBJECT 
  */
@@ -212,6 +230,7 @@ _seahorse_pgp_key_set_uids (SeahorsePgpKey *self, GList *uids)
 
 	seahorse_object_list_free (self->pv->uids);
 	self->pv->uids = seahorse_object_list_copy (uids);
+	self->pv->uids_generation++;
 
 	g_object_notify (G_OBJECT (self), "uids");
 }
@@ -280,6 +299,30 @@ seahorse_pgp_key_realize (SeahorsePgpKey *self)
 	SeahorseUsage usage;
 	GList *subkeys;
 	GIcon *icon;
+	guint flags, stamp;
+
+	/* The label and markup only change with the UID list, UID text or flags */
+	flags = seahorse_object_get_flags (SEAHORSE_OBJECT (self));
+	stamp = calc_uids_stamp (self);
+	if (!self->pv->display_built ||
+	    self->pv->display_flags != flags ||
+	    self->pv->display_generation != self->pv->uids_generation ||
+	    self->pv->display_stamp != stamp) {
+		name = calc_name (self);
+		markup = calc_markup (self);
+		nickname = calc_short_name (self);
+		g_object_set (self,
+		              "label", name,
+		              "markup", markup,
+		              "nickname", nickname,
+		              NULL);
+		g_free (markup);
+		g_free (name);
+		self->pv->display_built = TRUE;
+		self->pv->display_flags = flags;
+		self->pv->display_generation = self->pv->uids_generation;
+		self->pv->display_stamp = stamp;
+	}
 
 	subkeys = seahorse_pgp_key_get_subkeys (self);
 	if (subkeys) {
@@ -289,10 +332,6 @@ seahorse_pgp_key_realize (SeahorsePgpKey *self)
 		identifier = g_strdup ("");
 	}
 
-	name = calc_name (self);
-	markup = calc_markup (self);
-	nickname = calc_short_name (self);
-
 	g_object_get (self, "usage", &usage, NULL);
 
 	/* The type */
@@ -306,17 +345,12 @@ seahorse_pgp_key_realize (SeahorsePgpKey *self)
 
 	icon = g_themed_icon_new (icon_name);
 	g_object_set (self,
-		      "label", name,
-		      "markup", markup,
-		      "nickname", nickname,
 		      "identifier", identifier,
 		      "icon", icon,
 		      NULL);
 
 	g_object_unref (icon);
 	g_free (identifier);
-	g_free (markup);
-	g_free (name);
 }
 
 static void
@@ -0,0 +1,200 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "seahorse-pgp-packets.h"
+
+/* User attribute subpacket holding an image, RFC 4880 5.12.1 */
+#define SUBPACKET_IMAGE         1
+#define IMAGE_HEADER_VERSION    1
+#define IMAGE_ENCODING_JPEG     1
+
+/* Reads a new format length, as used by packets and subpackets */
+static gboolean
+read_new_length (const guchar **data,
+                 gsize *n_data,
+                 gsize *length)
+{
+	const guchar *at = *data;
+	gsize n_at = *n_data;
+
+	if (n_at < 1)
+		return FALSE;
+
+	if (at[0] < 192) {
+		*length = at[0];
+		at += 1;
+		n_at -= 1;
+
+	} else if (at[0] < 224) {
+		if (n_at < 2)
+			return FALSE;
+		*length = ((at[0] - 192) << 8) + at[1] + 192;
+		at += 2;
+		n_at -= 2;
+
+	} else if (at[0] == 255) {
+		if (n_at < 5)
+			return FALSE;
+		*length = ((gsize)at[1] << 24) | ((gsize)at[2] << 16) |
+		          ((gsize)at[3] << 8) | (gsize)at[4];
+		at += 5;
+		n_at -= 5;
+
+	/* Partial body lengths never appear in exported keys */
+	} else {
+		return FALSE;
+	}
+
+	*data = at;
+	*n_data = n_at;
+	return TRUE;
+}
+
+/**
+ * seahorse_pgp_packet_next:
+ * @data: The data to read from, advanced past the packet
+ * @n_data: Length of @data, reduced by the length of the packet
+ * @packet: Filled in with the packet, which points into @data
+ *
+ * Reads the next packet from a buffer of binary OpenPGP data.
+ *
+ * Returns: FALSE at the end of the data, or if it isn't valid.
+ **/
+gboolean
+seahorse_pgp_packet_next (const guchar **data,
+                          gsize *n_data,
+                          SeahorsePgpPacket *packet)
+{
+	const guchar *at;
+	gsize n_at;
+	gsize length;
+	guint i, n_length;
+
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (n_data != NULL, FALSE);
+	g_return_val_if_fail (packet != NULL, FALSE);
+
+	at = *data;
+	n_at = *n_data;
+
+	if (n_at < 1 || !(at[0] & 0x80))
+		return FALSE;
+
+	/* New format packet header */
+	if (at[0] & 0x40) {
+		packet->tag = at[0] & 0x3f;
+		at += 1;
+		n_at -= 1;
+		if (!read_new_length (&at, &n_at, &length))
+			return FALSE;
+
+	/* Old format packet header */
+	} else {
+		packet->tag = (at[0] >> 2) & 0x0f;
+		switch (at[0] & 0x03) {
+		case 0:
+			n_length = 1;
+			break;
+		case 1:
+			n_length = 2;
+			break;
+		case 2:
+			n_length = 4;
+			break;
+		default:
+			n_length = 0;
+			break;
+		}
+
+		at += 1;
+		n_at -= 1;
+		if (n_at < n_length)
+			return FALSE;
+
+		/* An indeterminate length runs to the end of the data */
+		if (n_length == 0) {
+			length = n_at;
+		} else {
+			for (i = 0, length = 0; i < n_length; i++)
+				length = (length << 8) | at[i];
+			at += n_length;
+			n_at -= n_length;
+		}
+	}
+
+	if (length > n_at)
+		return FALSE;
+
+	packet->body = at;
+	packet->length = length;
+
+	*data = at + length;
+	*n_data = n_at - length;
+	return TRUE;
+}
+
+/**
+ * seahorse_pgp_packet_get_image:
+ * @packet: A user attribute packet
+ * @image: Filled in with the image data, which points into the packet
+ * @n_image: Filled in with the length of the image data
+ *
+ * Finds the JPEG image in a user attribute packet, as used by photo IDs.
+ *
+ * Returns: Whether the packet contains a JPEG image.
+ **/
+gboolean
+seahorse_pgp_packet_get_image (const SeahorsePgpPacket *packet,
+                               const guchar **image,
+                               gsize *n_image)
+{
+	const guchar *at;
+	gsize n_at;
+	gsize length;
+	gsize header;
+
+	g_return_val_if_fail (packet != NULL, FALSE);
+
+	if (packet->tag != SEAHORSE_PGP_PACKET_USER_ATTRIBUTE)
+		return FALSE;
+
+	at = packet->body;
+	n_at = packet->length;
+
+	while (n_at > 0) {
+		if (!read_new_length (&at, &n_at, &length) || length < 1 || length > n_at)
+			return FALSE;
+
+		/* The image header length is little endian, unlike everything else */
+		if (at[0] == SUBPACKET_IMAGE && length >= 5) {
+			header = at[1] | (at[2] << 8);
+			if (header >= 4 && header < length &&
+			    at[3] == IMAGE_HEADER_VERSION && at[4] == IMAGE_ENCODING_JPEG) {
+				*image = at + 1 + header;
+				*n_image = length - 1 - header;
+				return TRUE;
+			}
+		}
+
+		at += length;
+		n_at -= length;
+	}
+
+	return FALSE;
+}
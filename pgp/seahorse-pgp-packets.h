@@ -0,0 +1,53 @@
+/*
+ * Seahorse
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * A minimal reader for binary OpenPGP packets (RFC 4880), enough to pick
+ * apart an exported key without running gpg.
+ */
+
+#ifndef __SEAHORSE_PGP_PACKETS_H__
+#define __SEAHORSE_PGP_PACKETS_H__
+
+#include <glib.h>
+
+typedef enum {
+	SEAHORSE_PGP_PACKET_SIGNATURE = 2,
+	SEAHORSE_PGP_PACKET_SECRET_KEY = 5,
+	SEAHORSE_PGP_PACKET_PUBLIC_KEY = 6,
+	SEAHORSE_PGP_PACKET_SECRET_SUBKEY = 7,
+	SEAHORSE_PGP_PACKET_TRUST = 12,
+	SEAHORSE_PGP_PACKET_USER_ID = 13,
+	SEAHORSE_PGP_PACKET_PUBLIC_SUBKEY = 14,
+	SEAHORSE_PGP_PACKET_USER_ATTRIBUTE = 17
+} SeahorsePgpPacketTag;
+
+typedef struct {
+	SeahorsePgpPacketTag tag;
+	const guchar *body;
+	gsize length;
+} SeahorsePgpPacket;
+
+gboolean        seahorse_pgp_packet_next          (const guchar **data,
+                                                   gsize *n_data,
+                                                   SeahorsePgpPacket *packet);
+
+gboolean        seahorse_pgp_packet_get_image     (const SeahorsePgpPacket *packet,
+                                                   const guchar **image,
+                                                   gsize *n_image);
+
+#endif /* __SEAHORSE_PGP_PACKETS_H__ */
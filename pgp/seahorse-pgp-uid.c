@@ -50,8 +50,12 @@ struct _SeahorsePgpUidPrivate {
 	gchar *name;
 	gchar *email;
 	gchar *comment;
+	guint text_stamp;
 };
 
+/* Increases with every change to the text of any UID */
+static guint text_stamp_counter = 0;
+
 /* -----------------------------------------------------------------------------
  * INTERNAL HELPERS
  */
@@ -429,11 +433,20 @@ void
 seahorse_pgp_uid_set_name (SeahorsePgpUid *self, const gchar *name)
 {
 	GObject *obj;
+	gchar *value;
 	
 	g_return_if_fail (SEAHORSE_IS_PGP_UID (self));
-	
+
+	/* Keys cache their display text, so leave the stamp alone if unchanged */
+	value = convert_string (name);
+	if (self->pv->realized && g_strcmp0 (value, self->pv->name) == 0) {
+		g_free (value);
+		return;
+	}
+
 	g_free (self->pv->name);
-	self->pv->name = convert_string (name);
+	self->pv->name = value;
+	self->pv->text_stamp = ++text_stamp_counter;
 	
 	obj = G_OBJECT (self);
 	g_object_freeze_notify (obj);
@@ -456,11 +469,19 @@ void
 seahorse_pgp_uid_set_email (SeahorsePgpUid *self, const gchar *email)
 {
 	GObject *obj;
+	gchar *value;
 	
 	g_return_if_fail (SEAHORSE_IS_PGP_UID (self));
-	
+
+	value = convert_string (email);
+	if (self->pv->realized && g_strcmp0 (value, self->pv->email) == 0) {
+		g_free (value);
+		return;
+	}
+
 	g_free (self->pv->email);
-	self->pv->email = convert_string (email);
+	self->pv->email = value;
+	self->pv->text_stamp = ++text_stamp_counter;
 	
 	obj = G_OBJECT (self);
 	g_object_freeze_notify (obj);
@@ -483,11 +504,19 @@ void
 seahorse_pgp_uid_set_comment (SeahorsePgpUid *self, const gchar *comment)
 {
 	GObject *obj;
+	gchar *value;
 	
 	g_return_if_fail (SEAHORSE_IS_PGP_UID (self));
-	
+
+	value = convert_string (comment);
+	if (self->pv->realized && g_strcmp0 (value, self->pv->comment) == 0) {
+		g_free (value);
+		return;
+	}
+
 	g_free (self->pv->comment);
-	self->pv->comment = convert_string (comment);
+	self->pv->comment = value;
+	self->pv->text_stamp = ++text_stamp_counter;
 	
 	obj = G_OBJECT (self);
 	g_object_freeze_notify (obj);
@@ -497,6 +526,22 @@ seahorse_pgp_uid_set_comment (SeahorsePgpUid *self, const gchar *comment)
 	g_object_thaw_notify (obj);
 }
 
+/**
+ * seahorse_pgp_uid_get_text_stamp:
+ * @self: the UID
+ *
+ * Get a stamp that changes whenever the name, email or comment of the
+ * UID changes. Stamps only ever increase, across all UIDs.
+ *
+ * Returns: the stamp of the last text change, or zero
+ */
+guint
+seahorse_pgp_uid_get_text_stamp (SeahorsePgpUid *self)
+{
+	g_return_val_if_fail (SEAHORSE_IS_PGP_UID (self), 0);
+	return self->pv->text_stamp;
+}
+
 gchar*
 seahorse_pgp_uid_calc_label (const gchar *name, const gchar *email, 
                              const gchar *comment)
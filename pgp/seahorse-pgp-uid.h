@@ -82,6 +82,8 @@ const gchar*      seahorse_pgp_uid_get_comment          (SeahorsePgpUid *self);
 void              seahorse_pgp_uid_set_comment          (SeahorsePgpUid *self,
                                                          const gchar *comment);
 
+guint             seahorse_pgp_uid_get_text_stamp       (SeahorsePgpUid *self);
+
 gchar*            seahorse_pgp_uid_calc_label           (const gchar *name,
                                                          const gchar *email,
                                                          const gchar *comment);
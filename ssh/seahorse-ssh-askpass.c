@@ -24,9 +24,14 @@
 
 #include "libseahorse/seahorse-passphrase.h"
 
+#include <sys/file.h>
+
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <glib.h>
 #include <glib/gi18n.h>
@@ -36,6 +41,34 @@
 #include <gdk/gdkx.h>
 #endif
 
+/*
+ * Wait until no other serialized prompt is showing. The lock goes away
+ * when we exit. Returns FALSE if ssh went away while we were waiting.
+ */
+static gboolean
+wait_for_prompt_turn (void)
+{
+	gchar *filename;
+	pid_t parent;
+	int fd;
+
+	parent = getppid ();
+	filename = g_build_filename (g_get_user_runtime_dir (), "seahorse-ssh-askpass.lock", NULL);
+	fd = open (filename, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd == -1)
+		g_warning ("couldn't open prompt lock file: %s: %s", filename, g_strerror (errno));
+	g_free (filename);
+
+	while (fd != -1 && flock (fd, LOCK_EX) == -1) {
+		if (errno != EINTR) {
+			g_warning ("couldn't lock prompt lock file: %s", g_strerror (errno));
+			break;
+		}
+	}
+
+	return getppid () == parent;
+}
+
 int
 main (int argc, char* argv[])
 {
@@ -92,6 +125,10 @@ main (int argc, char* argv[])
 	flags = g_getenv ("SEAHORSE_SSH_ASKPASS_FLAGS");
 	if (!flags)
 		flags = "";
+	if (strstr (flags, "serialize") && !wait_for_prompt_turn ()) {
+		g_free (message);
+		return 1;
+	}
 	if (strstr (flags, "multiple")) {
 		gchar *lower = g_ascii_strdown (message, -1);
 
@@ -19,6 +19,11 @@
 
 #include "config.h"
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <glib/gstdio.h>
 
 #include "seahorse-ssh-key-data.h"
 #include "seahorse-ssh-source.h"
@@ -32,122 +37,186 @@
  * HELPERS
  */
 
-static gsize
-calc_bits (guint algo, gsize len)
+/* Reads a length prefixed string from SSH wire format data */
+static gboolean
+read_string (const guchar **at, const guchar *end,
+             const guchar **value, gsize *n_value)
 {
-    gsize n;
-    
-    /*
-     * To keep us from having to parse a BIGNUM and link to 
-     * openssl, these are from the hip guesses at the bits 
-     * of a key based on the size of the binary blob in 
-     * the public key.
-     */
-
-    switch (algo) {
-        
-    case SSH_ALGO_RSA:
-        /* Seems accurate to nearest 8 bits */
-        return ((len - 21) * 8);
-    
-    case SSH_ALGO_DSA:
-        /* DSA keys seem to only work at 'bits % 64 == 0' boundaries */
-        n = ((len - 50) * 8) / 3; 
-        return ((n / 64) + (((n % 64) > 32) ? 1 : 0)) * 64; /* round to 64 */
-    
-    default:
-        return 0;
-    }
+    guint32 len;
+
+    if (end - *at < 4)
+        return FALSE;
+    len = ((guint32)(*at)[0] << 24) | ((guint32)(*at)[1] << 16) |
+          ((guint32)(*at)[2] << 8) | (guint32)(*at)[3];
+    *at += 4;
+
+    if ((gsize)(end - *at) < len)
+        return FALSE;
+    *value = *at;
+    *n_value = len;
+    *at += len;
+    return TRUE;
 }
 
-static guint 
-parse_algo (const gchar *type)
+static gboolean
+string_equals (const guchar *value, gsize n_value, const gchar *str)
 {
-    if (strstr (type, "rsa") || strstr (type, "RSA"))
-        return SSH_ALGO_RSA;
-    if (strstr (type, "dsa") || strstr (type, "dss") || 
-        strstr (type, "DSA") || strstr (type, "DSS"))
-        return SSH_ALGO_DSA;
-    
-    return SSH_ALGO_UNK;
+    return n_value == strlen (str) && memcmp (value, str, n_value) == 0;
+}
+
+/* The number of significant bits in a big endian multiple precision integer */
+static guint
+mpint_bits (const guchar *num, gsize n_num)
+{
+    guchar top;
+    guint bits;
+
+    /* Skip leading zeros, including the sign byte */
+    while (n_num > 0 && *num == 0) {
+        num++;
+        n_num--;
+    }
+
+    if (n_num == 0)
+        return 0;
+
+    bits = (n_num - 1) * 8;
+    for (top = *num; top != 0; top >>= 1)
+        bits++;
+    return bits;
 }
 
+/*
+ * Decodes the algorithm and key size from the public key blob. The blob
+ * starts with the key type, followed by the parts of the key for that type.
+ */
 static gboolean
-parse_key_blob (guchar *bytes, gsize len, SeahorseSSHKeyData *data)
+parse_key_blob (const guchar *bytes, gsize len, SeahorseSSHKeyData *data)
+{
+    const guchar *at = bytes;
+    const guchar *end = bytes + len;
+    const guchar *type, *value;
+    gsize n_type, n_value;
+    GString *fingerprint;
+    gchar *digest;
+    gsize n_digest;
+    gsize i;
+
+    if (!read_string (&at, end, &type, &n_type))
+        return FALSE;
+
+    if (string_equals (type, n_type, "ssh-rsa")) {
+        /* The exponent, then the modulus */
+        if (!read_string (&at, end, &value, &n_value) ||
+            !read_string (&at, end, &value, &n_value))
+            return FALSE;
+        data->algo = SSH_ALGO_RSA;
+        data->length = mpint_bits (value, n_value);
+
+    } else if (string_equals (type, n_type, "ssh-dss")) {
+        /* The prime p comes first */
+        if (!read_string (&at, end, &value, &n_value))
+            return FALSE;
+        data->algo = SSH_ALGO_DSA;
+        data->length = mpint_bits (value, n_value);
+
+    } else if (n_type > 11 && memcmp (type, "ecdsa-sha2-", 11) == 0) {
+        /* The curve name */
+        if (!read_string (&at, end, &value, &n_value))
+            return FALSE;
+        data->algo = SSH_ALGO_ECDSA;
+        if (string_equals (value, n_value, "nistp256"))
+            data->length = 256;
+        else if (string_equals (value, n_value, "nistp384"))
+            data->length = 384;
+        else if (string_equals (value, n_value, "nistp521"))
+            data->length = 521;
+        else
+            data->length = 0;
+
+    } else if (string_equals (type, n_type, "ssh-ed25519")) {
+        if (!read_string (&at, end, &value, &n_value) || n_value != 32)
+            return FALSE;
+        data->algo = SSH_ALGO_ED25519;
+        data->length = 256;
+
+    } else {
+        return FALSE;
+    }
+
+    digest = g_compute_checksum_for_data (G_CHECKSUM_MD5, bytes, len);
+    if (!digest)
+        return FALSE;
+
+    n_digest = strlen (digest);
+    fingerprint = g_string_sized_new ((n_digest * 3) / 2);
+    for (i = 0; i < n_digest; i += 2) {
+        if (i > 0)
+            g_string_append_c (fingerprint, ':');
+        g_string_append_len (fingerprint, digest + i, 2);
+    }
+
+    g_free (digest);
+    data->fingerprint = g_string_free (fingerprint, FALSE);
+
+    return TRUE;
+}
+
+/* Decodes the base64 blob that follows the key type on a public key line */
+static guchar *
+decode_key_blob (const gchar *line, gsize *n_blob, const gchar **rest)
 {
-	GString *fingerprint;
-	gchar *digest;
-	gsize n_digest;
-	gsize i;
-
-	digest = g_compute_checksum_for_data (G_CHECKSUM_MD5, bytes, len);
-	if (!digest)
-		return FALSE;
-
-	n_digest = strlen (digest);
-	fingerprint = g_string_sized_new ((n_digest * 3) / 2);
-	for (i = 0; i < n_digest; i += 2) {
-		if (i > 0)
-			g_string_append_c (fingerprint, ':');
-		g_string_append_len (fingerprint, digest + i, 2);
-	}
-
-	g_free (digest);
-	data->fingerprint = g_string_free (fingerprint, FALSE);
-
-	return TRUE;
+    const gchar *start, *end;
+    gchar *base64;
+    guchar *blob;
+
+    /* Skip over the key type */
+    for (start = line; *start && !g_ascii_isspace (*start); start++)
+        ;
+    for (; *start && g_ascii_isspace (*start); start++)
+        ;
+    for (end = start; *end && !g_ascii_isspace (*end); end++)
+        ;
+
+    if (end == start)
+        return NULL;
+
+    base64 = g_strndup (start, end - start);
+    blob = g_base64_decode (base64, n_blob);
+    g_free (base64);
+
+    if (rest)
+        *rest = *end ? end + 1 : NULL;
+    return blob;
 }
 
 static gboolean
 parse_key_data (gchar *line, SeahorseSSHKeyData *data)
 {
-    gchar* space;
+    const gchar *comment;
     guchar *bytes;
     gboolean ret;
     gsize len;
     
-    /* Get the type */
-    space = strchr (line, ' ');
-    if (space == NULL)
-        return FALSE;
-    *space = '\0';
-    data->algo = parse_algo (line);
-    *space = ' ';
-    if (data->algo == SSH_ALGO_UNK)
-        return FALSE;
-    
-    line = space + 1;
-    if (!*line)
-        return FALSE;
-    
-    /* Prepare for decoding */
-    g_strchug (line);
-    space = strchr (line, ' ');
-    if (space)
-        *space = 0;
-    g_strchomp (line);
-        
     /* Decode it, and parse binary stuff */
-    bytes = g_base64_decode (line, &len);
+    bytes = decode_key_blob (line, &len, &comment);
+    if (bytes == NULL)
+        return FALSE;
+
     ret = parse_key_blob (bytes, len, data);
     g_free (bytes);
     
     if (!ret)
         return FALSE;
     
-    /* The number of bits */
-    data->length = calc_bits (data->algo, len);
-    
     /* And the rest is the comment */
-    if (space) {
-        *space = ' ';
-        ++space;
+    if (comment) {
         
         /* If not utf8 valid, assume latin 1 */
-        if (!g_utf8_validate (space, -1, NULL))
-            data->comment = g_convert (space, -1, "UTF-8", "ISO-8859-1", NULL, NULL, NULL);
+        if (!g_utf8_validate (comment, -1, NULL))
+            data->comment = g_convert (comment, -1, "UTF-8", "ISO-8859-1", NULL, NULL, NULL);
         else
-            data->comment = g_strdup (space);
+            data->comment = g_strdup (comment);
     }
     
     return TRUE;
@@ -207,6 +276,8 @@ parse_private_data (gchar ***lx)
             secdata->algo = SSH_ALGO_RSA;
         else if (strstr (secdata->rawdata, " DSA "))
             secdata->algo = SSH_ALGO_DSA;
+        else if (strstr (secdata->rawdata, " EC "))
+            secdata->algo = SSH_ALGO_ECDSA;
         else
             secdata->algo = SSH_ALGO_UNK;
     } 
@@ -215,6 +286,203 @@ parse_private_data (gchar ***lx)
     return secdata;
 }
 
+/* -----------------------------------------------------------------------------
+ * FILE INDEX
+ *
+ * Files like authorized_keys can hold many thousands of keys. Rather than
+ * parse and fingerprint every line each time a key is added or removed, we
+ * remember where each key is in the file. The index is only valid as long
+ * as the file has the same device, inode, size and modification time. As
+ * a file can change within one timestamp tick, lines are checked again
+ * before they are removed.
+ */
+
+typedef struct {
+    gsize offset;
+    gsize length;               /* Not including the new line */
+    const gchar *fingerprint;   /* Owned by the fingerprints table, or NULL */
+} IndexLine;
+
+typedef struct {
+    guint64 device;
+    guint64 inode;
+    guint64 size;
+    guint64 mtime;
+    guint64 mtime_nsec;
+    GArray *lines;              /* IndexLine for each line in the file */
+    GHashTable *fingerprints;   /* fingerprint -> number of lines with it */
+} FileIndex;
+
+G_LOCK_DEFINE_STATIC (file_indexes);
+static GHashTable *file_indexes = NULL;
+
+static void
+file_index_free (gpointer data)
+{
+    FileIndex *index = data;
+    g_array_free (index->lines, TRUE);
+    g_hash_table_destroy (index->fingerprints);
+    g_free (index);
+}
+
+static void
+file_index_stamp (FileIndex *index, GStatBuf *sb)
+{
+    index->device = sb->st_dev;
+    index->inode = sb->st_ino;
+    index->size = sb->st_size;
+    index->mtime = sb->st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+    index->mtime_nsec = sb->st_mtim.tv_nsec;
+#endif
+}
+
+static gboolean
+file_index_is_valid (FileIndex *index, GStatBuf *sb)
+{
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+    if (index->mtime_nsec != (guint64)sb->st_mtim.tv_nsec)
+        return FALSE;
+#endif
+    return index->device == (guint64)sb->st_dev &&
+           index->inode == (guint64)sb->st_ino &&
+           index->size == (guint64)sb->st_size &&
+           index->mtime == (guint64)sb->st_mtime;
+}
+
+static void
+file_index_add_line (FileIndex *index, gsize offset, gsize length,
+                     const gchar *fingerprint)
+{
+    IndexLine line = { offset, length, NULL };
+    gpointer key, count;
+
+    if (fingerprint) {
+        if (g_hash_table_lookup_extended (index->fingerprints, fingerprint, &key, &count)) {
+            g_hash_table_insert (index->fingerprints, key, GUINT_TO_POINTER (GPOINTER_TO_UINT (count) + 1));
+        } else {
+            key = g_strdup (fingerprint);
+            g_hash_table_insert (index->fingerprints, key, GUINT_TO_POINTER (1));
+        }
+        line.fingerprint = key;
+    }
+
+    g_array_append_val (index->lines, line);
+}
+
+/* The line need not be null terminated, as it comes from a mapped file */
+static gchar *
+fingerprint_for_line (const gchar *line, gsize length)
+{
+    SeahorseSSHKeyData keydata = { 0, };
+    gchar *x;
+
+    /* Skip leading whitespace */
+    for (; length > 0 && g_ascii_isspace (*line); line++)
+        length--;
+
+    /* Comments and empty lines */
+    if (length == 0 || *line == '#')
+        return NULL;
+
+    x = g_strndup (line, length);
+    parse_key_data (x, &keydata);
+    g_free (keydata.comment);
+    g_free (x);
+
+    return keydata.fingerprint;
+}
+
+/*
+ * Lines are split on new lines just like g_strsplit() would, so that an
+ * empty file has no lines and a trailing new line makes an empty last line.
+ */
+static FileIndex *
+file_index_build (const gchar *contents, gsize length)
+{
+    FileIndex *index;
+    const gchar *end;
+    gchar *fingerprint;
+    gsize offset = 0;
+    gsize n_line;
+
+    index = g_new0 (FileIndex, 1);
+    index->lines = g_array_new (FALSE, FALSE, sizeof (IndexLine));
+    index->fingerprints = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    while (length > 0) {
+        end = memchr (contents + offset, '\n', length - offset);
+        n_line = end ? (gsize)(end - (contents + offset)) : length - offset;
+
+        fingerprint = fingerprint_for_line (contents + offset, n_line);
+        file_index_add_line (index, offset, n_line, fingerprint);
+        g_free (fingerprint);
+
+        if (!end)
+            break;
+        offset += n_line + 1;
+    }
+
+    return index;
+}
+
+/* Check that the lines with this fingerprint really hold it in the contents */
+static gboolean
+file_index_check_lines (FileIndex *index, const gchar *fingerprint,
+                        const gchar *contents, gsize length)
+{
+    IndexLine *line;
+    gchar *actual;
+    gboolean same;
+    guint i;
+
+    for (i = 0; i < index->lines->len; i++) {
+        line = &g_array_index (index->lines, IndexLine, i);
+        if (!line->fingerprint || strcmp (line->fingerprint, fingerprint) != 0)
+            continue;
+        if (line->offset > length || line->length > length - line->offset)
+            return FALSE;
+        actual = fingerprint_for_line (contents + line->offset, line->length);
+        same = g_strcmp0 (actual, fingerprint) == 0;
+        g_free (actual);
+        if (!same)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Call with the file_indexes lock held */
+static FileIndex *
+file_index_rebuild (const gchar *filename, GStatBuf *sb,
+                    const gchar *contents, gsize length)
+{
+    FileIndex *index;
+
+    index = file_index_build (contents, length);
+    file_index_stamp (index, sb);
+    g_hash_table_replace (file_indexes, g_strdup (filename), index);
+    return index;
+}
+
+/* Call with the file_indexes lock held */
+static FileIndex *
+file_index_lookup (const gchar *filename, GStatBuf *sb,
+                   const gchar *contents, gsize length)
+{
+    FileIndex *index;
+
+    if (!file_indexes)
+        file_indexes = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                              g_free, file_index_free);
+
+    index = g_hash_table_lookup (file_indexes, filename);
+    if (index && file_index_is_valid (index, sb))
+        return index;
+
+    return file_index_rebuild (filename, sb, contents, length);
+}
+
 /* -----------------------------------------------------------------------------
  * PUBLIC 
  */
@@ -359,51 +627,149 @@ gboolean
 seahorse_ssh_key_data_filter_file (const gchar *filename, SeahorseSSHKeyData *add, 
                                    SeahorseSSHKeyData *remove, GError **err)
 {
+    GMappedFile *mapped = NULL;
+    const gchar *contents = NULL;
+    gsize length = 0;
+    FileIndex *index;
+    IndexLine *line;
+    GArray *lines;
     GString *results;
-    gchar *contents = NULL;
-    gchar **lines, **l;
+    GStatBuf sb = { 0, };
+    gboolean removing;
     gboolean ret;
-    gboolean first = TRUE;
-    
+    guint i;
+    int fd;
+
     /* By default filter out teh one we're adding */
     if (!remove)
         remove = add;
-    
-    if (g_file_test (filename, G_FILE_TEST_EXISTS)) {
-        if (!g_file_get_contents (filename, &contents, NULL, err))
+
+    fd = g_open (filename, O_RDONLY, 0);
+    if (fd == -1 && errno != ENOENT) {
+        g_set_error (err, G_FILE_ERROR, g_file_error_from_errno (errno),
+                     "Couldn't open file '%s': %s", filename, g_strerror (errno));
+        return FALSE;
+    }
+
+    /* Stat the file we've opened, so the index matches what we read */
+    if (fd != -1) {
+        if (fstat (fd, &sb) == 0)
+            mapped = g_mapped_file_new_from_fd (fd, FALSE, err);
+        else
+            g_set_error (err, G_FILE_ERROR, g_file_error_from_errno (errno),
+                         "Couldn't stat file '%s': %s", filename, g_strerror (errno));
+        close (fd);
+        if (!mapped)
             return FALSE;
+        contents = g_mapped_file_get_contents (mapped);
+        length = g_mapped_file_get_length (mapped);
     }
 
-    lines = g_strsplit (contents ? contents : "", "\n", -1);
-    g_free (contents);
-    
-    results = g_string_new ("");
-    
-    /* Load each line */
-    for (l = lines; *l; l++) {
-        if (seahorse_ssh_key_data_match (*l, -1, remove))
+    G_LOCK (file_indexes);
+
+    index = file_index_lookup (filename, &sb, contents, length);
+    removing = remove && remove->fingerprint &&
+               g_hash_table_lookup (index->fingerprints, remove->fingerprint);
+
+    /* Never drop a line the stamp wrongly says is unchanged */
+    if (removing && !file_index_check_lines (index, remove->fingerprint, contents, length)) {
+        index = file_index_rebuild (filename, &sb, contents, length);
+        removing = g_hash_table_lookup (index->fingerprints, remove->fingerprint) != NULL;
+    }
+
+    /* Nothing to do */
+    if (!removing && !add) {
+        G_UNLOCK (file_indexes);
+        if (mapped)
+            g_mapped_file_unref (mapped);
+        return TRUE;
+    }
+
+    results = g_string_sized_new (length + (add ? strlen (add->rawdata) + 1 : 0));
+    lines = g_array_sized_new (FALSE, FALSE, sizeof (IndexLine), index->lines->len + 1);
+
+    /* Copy every line we're keeping, noting where it ends up */
+    for (i = 0; i < index->lines->len; i++) {
+        line = &g_array_index (index->lines, IndexLine, i);
+        if (removing && line->fingerprint &&
+            strcmp (line->fingerprint, remove->fingerprint) == 0)
             continue;
-        if (!first)
+        if (lines->len > 0)
             g_string_append_c (results, '\n');
-        first = FALSE;
-        g_string_append (results, *l);
+        g_string_append_len (results, contents + line->offset, line->length);
+        line->offset = results->len - line->length;
+        g_array_append_val (lines, *line);
     }
-    
+
+    if (removing)
+        g_hash_table_remove (index->fingerprints, remove->fingerprint);
+    g_array_free (index->lines, TRUE);
+    index->lines = lines;
+
     /* Add any that need adding */
     if (add) {
-        if(!first)
+        if (lines->len > 0)
             g_string_append_c (results, '\n');
+        file_index_add_line (index, results->len, strlen (add->rawdata), add->fingerprint);
         g_string_append (results, add->rawdata);
     }
-    
-    g_strfreev (lines);
-    
+
+    if (mapped)
+        g_mapped_file_unref (mapped);
+
     ret = seahorse_util_write_file_private (filename, results->str, err);
     g_string_free (results, TRUE);
-    
+
+    /* Keep the index we've updated, if we know what the file looks like now */
+    if (ret && g_stat (filename, &sb) == 0)
+        file_index_stamp (index, &sb);
+    else
+        g_hash_table_remove (file_indexes, filename);
+
+    G_UNLOCK (file_indexes);
+
     return ret;
 }
 
+/* The fingerprint as newer OpenSSH shows it, calculated when first needed */
+const gchar *
+seahorse_ssh_key_data_get_sha256_fingerprint (SeahorseSSHKeyData *data)
+{
+    GChecksum *checksum;
+    guint8 digest[32];
+    gsize n_digest = sizeof (digest);
+    guchar *blob;
+    gsize n_blob;
+    gchar *encoded;
+    gsize len;
+
+    g_return_val_if_fail (data != NULL, NULL);
+
+    if (data->sha256_fingerprint || !data->rawdata)
+        return data->sha256_fingerprint;
+
+    blob = decode_key_blob (data->rawdata, &n_blob, NULL);
+    if (blob == NULL)
+        return NULL;
+
+    checksum = g_checksum_new (G_CHECKSUM_SHA256);
+    g_checksum_update (checksum, blob, n_blob);
+    g_checksum_get_digest (checksum, digest, &n_digest);
+    g_checksum_free (checksum);
+    g_free (blob);
+
+    /* Base64 without the padding, like OpenSSH */
+    encoded = g_base64_encode (digest, n_digest);
+    len = strlen (encoded);
+    while (len > 0 && encoded[len - 1] == '=')
+        encoded[--len] = '\0';
+
+    data->sha256_fingerprint = g_strconcat ("SHA256:", encoded, NULL);
+    g_free (encoded);
+
+    return data->sha256_fingerprint;
+}
+
 gboolean
 seahorse_ssh_key_data_is_valid (SeahorseSSHKeyData *data)
 {
@@ -420,6 +786,7 @@ seahorse_ssh_key_data_dup (SeahorseSSHKeyData *data)
     n->rawdata = g_strdup (data->rawdata);
     n->comment = g_strdup (data->comment);
     n->fingerprint = g_strdup (data->fingerprint);
+    n->sha256_fingerprint = g_strdup (data->sha256_fingerprint);
     n->authorized = data->authorized;
     n->partial = data->partial;
     n->algo = data->algo;
@@ -438,6 +805,7 @@ seahorse_ssh_key_data_free (SeahorseSSHKeyData *data)
     g_free (data->rawdata);
     g_free (data->comment);
     g_free (data->fingerprint);
+    g_free (data->sha256_fingerprint);
     g_free (data);
 }
 
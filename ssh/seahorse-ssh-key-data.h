@@ -30,7 +30,9 @@
 enum {
     SSH_ALGO_UNK,
     SSH_ALGO_RSA,
-    SSH_ALGO_DSA
+    SSH_ALGO_DSA,
+    SSH_ALGO_ECDSA,
+    SSH_ALGO_ED25519
 };
 
 /* 
@@ -51,6 +53,7 @@ struct _SeahorseSSHKeyData {
     gchar *rawdata;         /* The raw data of the public key */
     gchar *comment;         /* The comment for the public key */
     gchar *fingerprint;     /* The full fingerprint hash */
+    gchar *sha256_fingerprint; /* Calculated when first needed */
     guint length;           /* Number of bits */
     guint algo;             /* Key algorithm */
     gboolean authorized;    /* Is in authorized_keys */
@@ -91,6 +94,8 @@ gboolean                seahorse_ssh_key_data_filter_file     (const gchar *file
                                                                SeahorseSSHKeyData *remove,
                                                                GError **error);
 
+const gchar*            seahorse_ssh_key_data_get_sha256_fingerprint (SeahorseSSHKeyData *data);
+
 gboolean                seahorse_ssh_key_data_is_valid        (SeahorseSSHKeyData *data);
 
 SeahorseSSHKeyData*     seahorse_ssh_key_data_dup             (SeahorseSSHKeyData *data);
@@ -291,6 +291,7 @@ do_details (SeahorseWidget *swidget)
     SeahorseSSHKey *skey;
     GtkWidget *widget;
     const gchar *label;
+    gchar *fingerprint;
     gchar *text;
 
     object = SEAHORSE_OBJECT (SEAHORSE_OBJECT_WIDGET (swidget)->object);
@@ -298,8 +299,14 @@ do_details (SeahorseWidget *swidget)
 
     widget = GTK_WIDGET (gtk_builder_get_object (swidget->gtkbuilder, "fingerprint-label"));
     if (widget) {
-        text = seahorse_ssh_key_get_fingerprint (skey);
+        label = seahorse_ssh_key_data_get_sha256_fingerprint (skey->keydata);
+        fingerprint = seahorse_ssh_key_get_fingerprint (skey);
+        if (label)
+            text = g_strdup_printf ("%s\nMD5:%s", label, fingerprint);
+        else
+            text = g_strdup (fingerprint);
         gtk_label_set_text (GTK_LABEL (widget), text);
+        g_free (fingerprint);
         g_free (text);
     }
 
@@ -400,6 +400,10 @@ seahorse_ssh_key_get_algo_str (SeahorseSSHKey *skey)
         return "RSA";
     case SSH_ALGO_DSA:
         return "DSA";
+    case SSH_ALGO_ECDSA:
+        return "ECDSA";
+    case SSH_ALGO_ED25519:
+        return "Ed25519";
     default:
         g_assert_not_reached ();
         return NULL;
@@ -27,6 +27,7 @@
 
 #include "seahorse-common.h"
 
+#include "libseahorse/seahorse-progress.h"
 #include "libseahorse/seahorse-util.h"
 
 #include <sys/wait.h>
@@ -47,6 +48,9 @@
 #define COMMAND_PASSWORD "PASSWORD "
 #define COMMAND_PASSWORD_LEN   9
 
+/* How many hosts we upload keys to at once */
+#define MAX_PARALLEL_UPLOADS   8
+
 typedef struct {
 	const gchar *title;
 	const gchar *message;
@@ -127,6 +131,10 @@ get_algorithm_text (guint algo)
         return "dsa";
     case SSH_ALGO_RSA:
         return "rsa";
+    case SSH_ALGO_ECDSA:
+        return "ecdsa";
+    case SSH_ALGO_ED25519:
+        return "ed25519";
     default:
         g_return_val_if_reached (NULL);
         break;
@@ -509,6 +517,76 @@ on_upload_send_complete (GObject *source,
 	g_object_unref (res);
 }
 
+/* The keys to upload, one per line */
+static gchar *
+upload_key_data (GList *keys)
+{
+	SeahorseSSHKeyData *keydata;
+	GString *data;
+	GList *l;
+
+	data = g_string_sized_new (1024);
+	for (l = keys; l != NULL; l = g_list_next (l)) {
+		keydata = seahorse_ssh_key_get_data (l->data);
+		if (keydata && keydata->pubfile) {
+			g_string_append (data, keydata->rawdata);
+			g_string_append_c (data, '\n');
+		}
+	}
+
+	return g_string_free (data, FALSE);
+}
+
+static gchar *
+upload_command (const gchar *username,
+                const gchar *hostname,
+                const gchar *port)
+{
+	gchar *login, *control, *script, *remote;
+	gchar *elogin, *econtrol, *eremote, *eport;
+	gchar *cmd;
+
+	/*
+	 * This script creates the .ssh directory if necessary (with appropriate
+	 * permissions) and then appends each key onto the end of
+	 * .ssh/authorized_keys, unless it's already there. It's run with sh
+	 * since the login shell on the remote computer could be anything.
+	 */
+	script = g_strdup ("umask 077; test -d .ssh || mkdir .ssh; touch .ssh/authorized_keys; "
+	                   "while read -r type blob rest; do "
+	                   "grep -qF \"$type $blob\" .ssh/authorized_keys || "
+	                   "echo \"$type $blob${rest:+ $rest}\" >> .ssh/authorized_keys; "
+	                   "done");
+	eremote = escape_shell_arg (script);
+	remote = g_strdup_printf ("sh -c %s", eremote);
+	g_free (eremote);
+
+	/* Share connections to the same host, between these and later uploads */
+	control = g_strdup_printf ("ControlPath=%s/seahorse-ssh-%%r@%%h:%%p", g_get_user_runtime_dir ());
+
+	login = g_strdup_printf ("%s@%s", username, hostname);
+	elogin = escape_shell_arg (login);
+	econtrol = escape_shell_arg (control);
+	eremote = escape_shell_arg (remote);
+	eport = port ? escape_shell_arg (port) : NULL;
+
+	/* TODO: Important, we should handle the host checking properly */
+	cmd = g_strdup_printf (SSH_PATH " %s %s %s -o StrictHostKeyChecking=no "
+	                       "-o ControlMaster=auto -o %s -o ControlPersist=60 %s",
+	                       elogin, eport ? "-p" : "", eport ? eport : "", econtrol, eremote);
+
+	g_free (login);
+	g_free (control);
+	g_free (script);
+	g_free (remote);
+	g_free (elogin);
+	g_free (econtrol);
+	g_free (eremote);
+	g_free (eport);
+
+	return cmd;
+}
+
 void
 seahorse_ssh_op_upload_async (SeahorseSSHSource *source,
                               GList *keys,
@@ -520,11 +598,9 @@ seahorse_ssh_op_upload_async (SeahorseSSHSource *source,
                               GAsyncReadyCallback callback,
                               gpointer user_data)
 {
-	SeahorseSshPromptInfo prompt = { _("Remote Host Password"), NULL, NULL, NULL };
-	SeahorseSSHKeyData *keydata;
+	SeahorseSshPromptInfo prompt = { _("Remote Host Password"), NULL, NULL, "serialize" };
 	GSimpleAsyncResult *res;
-	GString *data;
-	GList *l;
+	gchar *data;
 	gchar *cmd;
 
 	g_return_if_fail (keys != NULL);
@@ -537,29 +613,15 @@ seahorse_ssh_op_upload_async (SeahorseSSHSource *source,
 	res = g_simple_async_result_new (G_OBJECT (source), callback, user_data,
 	                                 seahorse_ssh_op_upload_async);
 
-	data = g_string_sized_new (1024);
-	for (l = keys; l != NULL; l = g_list_next (l)) {
-		keydata = seahorse_ssh_key_get_data (l->data);
-		if (keydata && keydata->pubfile) {
-			g_string_append (data, keydata->rawdata);
-			g_string_append_c (data, '\n');
-		}
-	}
-
-	/*
-	 * This command creates the .ssh directory if necessary (with appropriate permissions)
-	 * and then appends all input data onto the end of .ssh/authorized_keys
-	 */
-	/* TODO: Important, we should handle the host checking properly */
-	cmd = g_strdup_printf (SSH_PATH " '%s@%s' %s %s -o StrictHostKeyChecking=no "
-	                       "\"umask 077; test -d .ssh || mkdir .ssh ; cat >> .ssh/authorized_keys\"",
-	                       username, hostname, port ? "-p" : "", port ? port : "");
+	data = upload_key_data (keys);
+	cmd = upload_command (username, hostname, port);
 
-	seahorse_ssh_operation_async (SEAHORSE_SSH_SOURCE (source), cmd, data->str, data->len,
+	seahorse_ssh_operation_async (SEAHORSE_SSH_SOURCE (source), cmd, data, -1,
 	                              transient_for, cancellable, on_upload_send_complete,
 	                              &prompt, g_object_ref (res));
 
-	g_string_free (data, TRUE);
+	g_free (data);
+	g_free (cmd);
 	g_object_unref (res);
 
 }
@@ -578,6 +640,255 @@ seahorse_ssh_op_upload_finish (SeahorseSSHSource *source,
 	return TRUE;
 }
 
+typedef struct {
+	SeahorseSSHSource *source;
+	GCancellable *cancellable;
+	GtkWindow *transient_for;
+	gchar *username;
+	gchar *data;
+	GQueue *pending;
+	guint running;
+	guint completed;
+	guint total;
+	GString *failures;
+} ssh_upload_many_closure;
+
+typedef struct {
+	GSimpleAsyncResult *res;
+	gchar *target;
+} ssh_upload_target;
+
+static void
+ssh_upload_many_free (gpointer data)
+{
+	ssh_upload_many_closure *closure = data;
+	g_assert (closure->running == 0);
+	g_object_unref (closure->source);
+	g_clear_object (&closure->cancellable);
+	g_clear_object (&closure->transient_for);
+	g_free (closure->username);
+	g_free (closure->data);
+	g_queue_free_full (closure->pending, g_free);
+	g_string_free (closure->failures, TRUE);
+	g_free (closure);
+}
+
+static void       upload_to_next_targets          (GSimpleAsyncResult *res);
+
+static void
+on_upload_target_complete (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+	ssh_upload_target *target = user_data;
+	GSimpleAsyncResult *res = target->res;
+	ssh_upload_many_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
+	GString *output;
+
+	g_assert (closure->running > 0);
+	closure->running--;
+	closure->completed++;
+
+	output = seahorse_ssh_operation_finish (SEAHORSE_SSH_SOURCE (source), result, &error);
+	if (output != NULL) {
+		g_string_free (output, TRUE);
+		seahorse_progress_update (closure->cancellable, res,
+		                          _("Configured %s (%d of %d computers)"),
+		                          target->target, closure->completed, closure->total);
+	} else {
+		g_message ("couldn't upload keys to %s: %s", target->target, error->message);
+		if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+			g_string_append_printf (closure->failures, "\n%s: %s",
+			                        target->target, error->message);
+		seahorse_progress_update (closure->cancellable, res,
+		                          _("Couldn't configure %s (%d of %d computers)"),
+		                          target->target, closure->completed, closure->total);
+		g_error_free (error);
+	}
+
+	upload_to_next_targets (res);
+
+	g_free (target->target);
+	g_free (target);
+	g_object_unref (res);
+}
+
+/**
+ * seahorse_ssh_op_parse_target:
+ * @target: a computer to upload to, like [user@]host[:port]
+ * @default_username: the user when @target doesn't have one
+ * @username: (out): location for the user name
+ * @hostname: (out): location for the host name
+ * @port: (out): location for the port, or %NULL when there is none
+ *
+ * Split up a computer to upload keys to, as entered by the user.
+ */
+void
+seahorse_ssh_op_parse_target (const gchar *target,
+                              const gchar *default_username,
+                              gchar **username,
+                              gchar **hostname,
+                              gchar **port)
+{
+	const gchar *at;
+	gchar *colon;
+
+	g_return_if_fail (target != NULL);
+	g_return_if_fail (username != NULL && hostname != NULL && port != NULL);
+
+	at = strrchr (target, '@');
+	if (at) {
+		*username = g_strndup (target, at - target);
+		*hostname = g_strdup (at + 1);
+	} else {
+		*username = g_strdup (default_username);
+		*hostname = g_strdup (target);
+	}
+
+	*port = NULL;
+	colon = strchr (*hostname, ':');
+	if (colon) {
+		*colon = 0;
+		*port = g_strdup (colon + 1);
+		seahorse_util_string_trim_whitespace (*port);
+		if (!(*port)[0]) {
+			g_free (*port);
+			*port = NULL;
+		}
+	}
+
+	seahorse_util_string_trim_whitespace (*username);
+	seahorse_util_string_trim_whitespace (*hostname);
+}
+
+static void
+upload_to_target (GSimpleAsyncResult *res,
+                  const gchar *target)
+{
+	ssh_upload_many_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+
+	/* The askpass helper shows one of these prompts at a time */
+	SeahorseSshPromptInfo prompt = { _("Remote Host Password"), NULL, NULL, "serialize" };
+	ssh_upload_target *upload;
+	gchar *username, *hostname, *port;
+	gchar *cmd;
+	gchar *message;
+
+	seahorse_ssh_op_parse_target (target, closure->username, &username, &hostname, &port);
+
+	message = g_strdup_printf (_("Password for %s on %s"), username, hostname);
+	prompt.message = message;
+
+	upload = g_new0 (ssh_upload_target, 1);
+	upload->res = g_object_ref (res);
+	upload->target = g_strdup (target);
+
+	cmd = upload_command (username, hostname, port);
+	closure->running++;
+	seahorse_ssh_operation_async (closure->source, cmd, closure->data, -1,
+	                              closure->transient_for, closure->cancellable,
+	                              on_upload_target_complete, &prompt, upload);
+
+	g_free (cmd);
+	g_free (message);
+	g_free (username);
+	g_free (hostname);
+	g_free (port);
+}
+
+static void
+upload_to_next_targets (GSimpleAsyncResult *res)
+{
+	ssh_upload_many_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	gchar *target;
+
+	while (closure->running < MAX_PARALLEL_UPLOADS &&
+	       !g_cancellable_is_cancelled (closure->cancellable)) {
+		target = g_queue_pop_head (closure->pending);
+		if (target == NULL)
+			break;
+		upload_to_target (res, target);
+		g_free (target);
+	}
+
+	if (closure->running > 0)
+		return;
+
+	if (g_cancellable_is_cancelled (closure->cancellable)) {
+		g_simple_async_result_set_error (res, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+		                                 _("The operation was cancelled"));
+	} else if (closure->failures->len > 0) {
+		g_simple_async_result_set_error (res, SEAHORSE_ERROR, 0,
+		                                 _("Couldn't configure keys on some computers:%s"),
+		                                 closure->failures->str);
+	}
+
+	seahorse_progress_end (closure->cancellable, res);
+	g_simple_async_result_complete_in_idle (res);
+}
+
+/*
+ * Uploads to a few computers at a time. When any of them fail, the error
+ * lists each failed computer along with what went wrong.
+ */
+void
+seahorse_ssh_op_upload_many_async (SeahorseSSHSource *source,
+                                   GList *keys,
+                                   const gchar **targets,
+                                   const gchar *username,
+                                   GtkWindow *transient_for,
+                                   GCancellable *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data)
+{
+	ssh_upload_many_closure *closure;
+	GSimpleAsyncResult *res;
+	guint i;
+
+	g_return_if_fail (SEAHORSE_IS_SSH_SOURCE (source));
+	g_return_if_fail (keys != NULL);
+	g_return_if_fail (targets != NULL);
+	g_return_if_fail (username && username[0]);
+
+	res = g_simple_async_result_new (G_OBJECT (source), callback, user_data,
+	                                 seahorse_ssh_op_upload_many_async);
+	closure = g_new0 (ssh_upload_many_closure, 1);
+	closure->source = g_object_ref (source);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	closure->transient_for = transient_for ? g_object_ref (transient_for) : NULL;
+	closure->username = g_strdup (username);
+	closure->data = upload_key_data (keys);
+	closure->pending = g_queue_new ();
+	closure->failures = g_string_new ("");
+	g_simple_async_result_set_op_res_gpointer (res, closure, ssh_upload_many_free);
+
+	for (i = 0; targets[i] != NULL; i++) {
+		if (targets[i][0])
+			g_queue_push_tail (closure->pending, g_strdup (targets[i]));
+	}
+	closure->total = g_queue_get_length (closure->pending);
+
+	seahorse_progress_prep_and_begin (cancellable, res, NULL);
+	upload_to_next_targets (res);
+
+	g_object_unref (res);
+}
+
+gboolean
+seahorse_ssh_op_upload_many_finish (SeahorseSSHSource *source,
+                                    GAsyncResult *result,
+                                    GError **error)
+{
+	g_return_val_if_fail (g_simple_async_result_is_valid (result, G_OBJECT (source),
+	                      seahorse_ssh_op_upload_many_async), FALSE);
+
+	if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result), error))
+		return FALSE;
+
+	return TRUE;
+}
+
 /* -----------------------------------------------------------------------------
  * CHANGE PASSPHRASE 
  */
@@ -39,6 +39,25 @@ gboolean          seahorse_ssh_op_upload_finish            (SeahorseSSHSource *s
                                                             GAsyncResult *result,
                                                             GError **error);
 
+void              seahorse_ssh_op_upload_many_async        (SeahorseSSHSource *source,
+                                                            GList *keys,
+                                                            const gchar **targets,
+                                                            const gchar *username,
+                                                            GtkWindow *transient_for,
+                                                            GCancellable *cancellable,
+                                                            GAsyncReadyCallback callback,
+                                                            gpointer user_data);
+
+gboolean          seahorse_ssh_op_upload_many_finish       (SeahorseSSHSource *source,
+                                                            GAsyncResult *result,
+                                                            GError **error);
+
+void              seahorse_ssh_op_parse_target             (const gchar *target,
+                                                            const gchar *default_username,
+                                                            gchar **username,
+                                                            gchar **hostname,
+                                                            gchar **port);
+
 void              seahorse_ssh_op_generate_async           (SeahorseSSHSource *source,
                                                             const gchar *email,
                                                             guint type,
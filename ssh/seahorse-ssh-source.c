@@ -38,6 +38,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 enum {
 	PROP_0,
@@ -51,15 +52,20 @@ enum {
 
 struct _SeahorseSSHSourcePrivate {
     gchar *ssh_homedir;                     /* Home directory for SSH keys */
-    guint scheduled_refresh;                /* Source for refresh timeout */
+    guint scheduled_refresh;                /* Blocks monitoring during a load */
+    guint scheduled_reload;                 /* Source for reloading changed files */
+    GHashTable *changed_files;              /* Files changed since the last reload */
     GFileMonitor *monitor_handle;           /* For monitoring the .ssh directory */
     GHashTable *keys;
+    GHashTable *stamps;                     /* Files we've looked at for keys */
 };
 
 static void       seahorse_ssh_source_place_iface       (SeahorsePlaceIface *iface);
 
 static void       seahorse_ssh_source_collection_iface  (GcrCollectionIface *iface);
 
+static gboolean   scheduled_reload                      (gpointer user_data);
+
 G_DEFINE_TYPE_EXTENDED (SeahorseSSHSource, seahorse_ssh_source, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (GCR_TYPE_COLLECTION, seahorse_ssh_source_collection_iface);
                         G_IMPLEMENT_INTERFACE (SEAHORSE_TYPE_PLACE, seahorse_ssh_source_place_iface)
@@ -67,6 +73,30 @@ G_DEFINE_TYPE_EXTENDED (SeahorseSSHSource, seahorse_ssh_source, G_TYPE_OBJECT, 0
 
 #define AUTHORIZED_KEYS_FILE    "authorized_keys"
 #define OTHER_KEYS_FILE         "other_keys.seahorse"
+#define KNOWN_HOSTS_FILE        "known_hosts"
+#define CONFIG_FILE             "config"
+
+/* Amount of keys the loading thread parses before handing them over */
+#define DEFAULT_LOAD_BATCH      50
+
+/* Files outside these sizes are never considered as private keys */
+#define PRIVATE_KEY_MIN_SIZE    128
+#define PRIVATE_KEY_MAX_SIZE    (64 * 1024)
+
+typedef struct {
+	guint64 device;
+	guint64 inode;
+	guint64 size;
+	guint64 mtime;
+	guint64 mtime_nsec;
+} FileStamp;
+
+/* What a private key file and its public key looked like when last loaded */
+typedef struct {
+	FileStamp privfile;
+	FileStamp pubfile;
+	gboolean is_key;
+} KeyFileStamp;
 
 /* -----------------------------------------------------------------------------
  * INTERNAL
@@ -81,25 +111,14 @@ check_data_for_ssh_private (SeahorseSSHSource *ssrc, const gchar *data)
     return FALSE;
 }
 
+/* Only reads the start of the file, where the signature is */
 static gboolean
-check_file_for_ssh_private (SeahorseSSHSource *ssrc, const gchar *filename)
+check_fd_for_ssh_private (SeahorseSSHSource *ssrc, int fd, const gchar *filename)
 {
     gchar buf[128];
-    int fd, r;
-    
-    if(!g_file_test (filename, G_FILE_TEST_IS_REGULAR))
-        return FALSE;
-    
-    fd = open (filename, O_RDONLY, 0);
-    if (fd == -1) {
-        g_warning ("couldn't open file to check for SSH key: %s: %s", 
-                   filename, g_strerror (errno));
-        return FALSE;
-    }
-    
+    int r;
+
     r = read (fd, buf, sizeof (buf));
-    close (fd);
-    
     if (r == -1) {
         g_warning ("couldn't read file to check for SSH key: %s: %s", 
                    filename, g_strerror (errno));
@@ -116,6 +135,40 @@ check_file_for_ssh_private (SeahorseSSHSource *ssrc, const gchar *filename)
     return check_data_for_ssh_private (ssrc, buf);
 }
 
+static gboolean
+check_file_for_ssh_private (SeahorseSSHSource *ssrc, const gchar *filename)
+{
+    gboolean ret;
+    int fd;
+    
+    if(!g_file_test (filename, G_FILE_TEST_IS_REGULAR))
+        return FALSE;
+    
+    fd = open (filename, O_RDONLY, 0);
+    if (fd == -1) {
+        g_warning ("couldn't open file to check for SSH key: %s: %s", 
+                   filename, g_strerror (errno));
+        return FALSE;
+    }
+    
+    ret = check_fd_for_ssh_private (ssrc, fd, filename);
+    close (fd);
+    
+    return ret;
+}
+
+static void
+file_stamp_for_stat (FileStamp *stamp, struct stat *sb)
+{
+	stamp->device = sb->st_dev;
+	stamp->inode = sb->st_ino;
+	stamp->size = sb->st_size;
+	stamp->mtime = sb->st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+	stamp->mtime_nsec = sb->st_mtim.tv_nsec;
+#endif
+}
+
 static void
 cancel_scheduled_refresh (SeahorseSSHSource *ssrc)
 {
@@ -139,13 +192,14 @@ remove_key_from_context (gpointer key,
 		seahorse_ssh_source_remove_object (self, skey);
 }
 
-static gboolean
-scheduled_refresh (SeahorseSSHSource *ssrc)
+static void
+cancel_scheduled_reload (SeahorseSSHSource *self)
 {
-    g_debug ("scheduled refresh event ocurring now");
-    cancel_scheduled_refresh (ssrc);
-    seahorse_place_load (SEAHORSE_PLACE (ssrc), NULL, NULL, NULL);
-    return FALSE; /* don't run again */    
+	if (self->priv->scheduled_reload != 0) {
+		g_source_remove (self->priv->scheduled_reload);
+		self->priv->scheduled_reload = 0;
+	}
+	g_hash_table_remove_all (self->priv->changed_files);
 }
 
 static gboolean
@@ -166,6 +220,42 @@ ends_with (const gchar *haystack, const gchar *needle)
     return strcmp (haystack + (hlen - nlen), needle) == 0;
 }
 
+/* Whether a change to this file could affect any of our keys */
+static gboolean
+is_key_file_change (SeahorseSSHSource *self,
+                    const gchar *path,
+                    GFileMonitorEvent event_type)
+{
+	gchar *basename;
+	gchar *privfile;
+	gboolean ret;
+
+	/* These change all the time, and never have keys we show */
+	basename = g_path_get_basename (path);
+	ret = g_str_has_prefix (basename, KNOWN_HOSTS_FILE) ||
+	      g_str_equal (basename, CONFIG_FILE);
+	g_free (basename);
+	if (ret)
+		return FALSE;
+
+	if (ends_with (path, AUTHORIZED_KEYS_FILE) || ends_with (path, OTHER_KEYS_FILE))
+		return TRUE;
+
+	/* Deleted files only matter if we have a key for them */
+	if (event_type == G_FILE_MONITOR_EVENT_DELETED) {
+		if (ends_with (path, ".pub"))
+			privfile = g_strndup (path, strlen (path) - 4);
+		else
+			privfile = g_strdup (path);
+		ret = g_hash_table_lookup (self->priv->keys, privfile) != NULL;
+		g_free (privfile);
+		return ret;
+	}
+
+	/* Sockets and other files that aren't regular never get read */
+	return ends_with (path, ".pub") || check_file_for_ssh_private (self, path);
+}
+
 static void
 monitor_ssh_homedir (GFileMonitor *handle, GFile *file, GFile *other_file,
                      GFileMonitorEvent event_type, SeahorseSSHSource *ssrc)
@@ -184,18 +274,16 @@ monitor_ssh_homedir (GFileMonitor *handle, GFile *file, GFile *other_file,
 		return;
 
 	/* Filter out any noise */
-	if (event_type != G_FILE_MONITOR_EVENT_DELETED && 
-	    !ends_with (path, AUTHORIZED_KEYS_FILE) &&
-	    !ends_with (path, OTHER_KEYS_FILE) && 
-		!ends_with (path, ".pub") &&
-	    !check_file_for_ssh_private (ssrc, path)) {
+	if (!g_hash_table_lookup (ssrc->priv->changed_files, path) &&
+	    !is_key_file_change (ssrc, path, event_type)) {
 		g_free (path);
 		return;
 	}
 
-	g_free (path);
-	g_debug ("scheduling refresh event due to file changes");
-	ssrc->priv->scheduled_refresh = g_timeout_add (500, (GSourceFunc)scheduled_refresh, ssrc);
+	g_debug ("scheduling reload of %s due to file changes", path);
+	g_hash_table_replace (ssrc->priv->changed_files, path, path);
+	if (ssrc->priv->scheduled_reload == 0)
+		ssrc->priv->scheduled_reload = g_timeout_add (500, scheduled_reload, ssrc);
 }
 
 static void
@@ -288,6 +376,7 @@ seahorse_ssh_source_dispose (GObject *gobject)
 
 	g_hash_table_remove_all (ssrc->priv->keys);
 	cancel_scheduled_refresh (ssrc);    
+	cancel_scheduled_reload (ssrc);
     
 	if (ssrc->priv->monitor_handle) {
 		g_object_unref (ssrc->priv->monitor_handle);
@@ -304,9 +393,12 @@ seahorse_ssh_source_finalize (GObject *gobject)
     g_assert (ssrc->priv);
 
     g_hash_table_destroy (ssrc->priv->keys);
+    g_hash_table_destroy (ssrc->priv->stamps);
+    g_hash_table_destroy (ssrc->priv->changed_files);
 
     /* All monitoring and scheduling should be done */
     g_assert (ssrc->priv->scheduled_refresh == 0);
+    g_assert (ssrc->priv->scheduled_reload == 0);
     g_assert (ssrc->priv->monitor_handle == 0);
     
     g_free (ssrc->priv);
@@ -325,6 +417,10 @@ seahorse_ssh_source_init (SeahorseSSHSource *ssrc)
 
 	ssrc->priv->keys = g_hash_table_new_full (g_str_hash, g_str_equal,
 	                                          g_free, g_object_unref);
+	ssrc->priv->stamps = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                            g_free, g_free);
+	ssrc->priv->changed_files = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                                   g_free, NULL);
 
 	ssrc->priv->scheduled_refresh = 0;
 	ssrc->priv->monitor_handle = NULL;
@@ -409,24 +505,66 @@ seahorse_ssh_source_collection_iface (GcrCollectionIface *iface)
 
 typedef struct {
 	SeahorseSSHSource *source;
+	GCancellable *cancellable;
 	GHashTable *loaded;
 	GHashTable *checks;
+	SeahorseSSHKey *last_key;
+
+	/* Only touched by the thread doing the parsing */
+	gchar *homedir;
+	gchar *authorized_file;
+	gchar *other_file;
 	gchar *pubfile;
 	gchar *privfile;
-	SeahorseSSHKey *last_key;
+	GPtrArray *batch;
+	GHashTable *stamps;                     /* As of the last load, read only */
+	GHashTable *new_stamps;                 /* Handed over once listed */
+
+	/* Shared with the loading thread, protected by mutex */
+	GMutex mutex;
+	GQueue *batches;                        /* GPtrArray of SeahorseSSHKeyData */
+	GPtrArray *unchanged;                   /* Private key files not reloaded */
+	guint merging;                          /* Source for merging batches */
+	gboolean listed;                        /* Loading thread is done */
+	GError *error;
 } source_load_closure;
 
+static void
+source_load_batch_free (gpointer data)
+{
+	GPtrArray *batch = data;
+	g_ptr_array_foreach (batch, (GFunc)seahorse_ssh_key_data_free, NULL);
+	g_ptr_array_free (batch, TRUE);
+}
+
 static void
 source_load_free (gpointer data)
 {
 	source_load_closure *closure = data;
+	g_assert (closure->merging == 0);
 	g_object_unref (closure->source);
+	g_clear_object (&closure->cancellable);
 	if (closure->loaded)
 		g_hash_table_destroy (closure->loaded);
 	if (closure->checks)
 		g_hash_table_destroy (closure->checks);
+	g_free (closure->homedir);
+	g_free (closure->authorized_file);
+	g_free (closure->other_file);
 	g_free (closure->pubfile);
 	g_free (closure->privfile);
+	if (closure->batch)
+		source_load_batch_free (closure->batch);
+	if (closure->batches)
+		g_queue_free_full (closure->batches, source_load_batch_free);
+	if (closure->unchanged)
+		g_ptr_array_free (closure->unchanged, TRUE);
+	if (closure->stamps)
+		g_hash_table_destroy (closure->stamps);
+	if (closure->new_stamps)
+		g_hash_table_destroy (closure->new_stamps);
+	g_mutex_clear (&closure->mutex);
+	g_clear_error (&closure->error);
 	g_free (closure);
 }
 
@@ -507,6 +645,125 @@ load_present_keys (SeahorseSSHSource *self)
 	return checks;
 }
 
+/* The stamps of files which weren't keys, or whose keys we still have */
+static GHashTable *
+load_present_stamps (SeahorseSSHSource *self)
+{
+	const gchar *filename;
+	KeyFileStamp *stamp;
+	GHashTable *stamps;
+	GHashTableIter iter;
+
+	stamps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	g_hash_table_iter_init (&iter, self->priv->stamps);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&filename, (gpointer *)&stamp)) {
+		if (!stamp->is_key || g_hash_table_lookup (self->priv->keys, filename))
+			g_hash_table_insert (stamps, g_strdup (filename),
+			                     g_memdup (stamp, sizeof (KeyFileStamp)));
+	}
+
+	return stamps;
+}
+
+/* Merges the batches the loading thread has parsed so far */
+static gboolean
+on_idle_merge_batches_of_keys (gpointer data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (data);
+	source_load_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GPtrArray *unchanged;
+	GQueue *batches;
+	GPtrArray *batch;
+	GError *error;
+	gboolean listed;
+	guint i;
+
+	g_mutex_lock (&closure->mutex);
+	batches = closure->batches;
+	closure->batches = g_queue_new ();
+	unchanged = closure->unchanged;
+	closure->unchanged = g_ptr_array_new_with_free_func (g_free);
+	listed = closure->listed;
+	error = closure->error;
+	closure->error = NULL;
+	closure->merging = 0;
+	g_mutex_unlock (&closure->mutex);
+
+	while ((batch = g_queue_pop_head (batches)) != NULL) {
+		/* Check and register the keys with the context, frees keydata */
+		for (i = 0; i < batch->len; i++)
+			ssh_key_from_data (closure->source, closure, batch->pdata[i]);
+		g_ptr_array_free (batch, TRUE);
+	}
+
+	g_queue_free (batches);
+
+	/* Keys whose files haven't changed are still present */
+	for (i = 0; i < unchanged->len; i++) {
+		g_hash_table_remove (closure->checks, unchanged->pdata[i]);
+		g_hash_table_replace (closure->loaded, g_strdup (unchanged->pdata[i]),
+		                      GUINT_TO_POINTER (TRUE));
+	}
+
+	g_ptr_array_free (unchanged, TRUE);
+
+	if (!listed)
+		return FALSE; /* The loading thread schedules us again */
+
+	if (error != NULL) {
+		g_simple_async_result_take_error (res, error);
+
+	/* Remove the keys that have disappeared */
+	} else if (!g_cancellable_is_cancelled (closure->cancellable)) {
+		g_hash_table_foreach (closure->checks, (GHFunc)remove_key_from_context,
+		                      closure->source);
+
+		/* Remember what the files looked like, for the next load */
+		g_hash_table_destroy (closure->source->priv->stamps);
+		closure->source->priv->stamps = closure->new_stamps;
+		closure->new_stamps = NULL;
+	}
+
+	g_simple_async_result_complete (res);
+	return FALSE; /* Remove event handler */
+}
+
+/* Hands the current batch over to the main loop */
+static void
+queue_batch_of_keys (GSimpleAsyncResult *res,
+                     source_load_closure *closure,
+                     gboolean listed)
+{
+	g_mutex_lock (&closure->mutex);
+
+	if (closure->batch->len > 0)
+		g_queue_push_tail (closure->batches, closure->batch);
+	else
+		g_ptr_array_free (closure->batch, TRUE);
+	closure->batch = listed ? NULL : g_ptr_array_new ();
+
+	closure->listed = listed;
+	if (closure->merging == 0)
+		closure->merging = g_idle_add_full (G_PRIORITY_LOW, on_idle_merge_batches_of_keys,
+		                                    g_object_ref (res), g_object_unref);
+
+	g_mutex_unlock (&closure->mutex);
+}
+
+static void
+found_key_data (source_load_closure *closure,
+                SeahorseSSHKeyData *data)
+{
+	/* When loading in a thread, keys are registered later on the main loop */
+	if (closure->batch) {
+		g_ptr_array_add (closure->batch, data);
+		return;
+	}
+
+	/* Check and register the key with the context, frees keydata */
+	closure->last_key = ssh_key_from_data (closure->source, closure, data);
+}
+
 static gboolean
 on_load_found_authorized_key (SeahorseSSHKeyData *data,
                               gpointer user_data)
@@ -517,8 +774,7 @@ on_load_found_authorized_key (SeahorseSSHKeyData *data,
 	data->partial = TRUE;
 	data->authorized = TRUE;
 
-	/* Check and register thet key with the context, frees keydata */
-	ssh_key_from_data (closure->source, closure, data);
+	found_key_data (closure, data);
 	return TRUE;
 }
 
@@ -532,8 +788,7 @@ on_load_found_other_key (SeahorseSSHKeyData *data,
 	data->partial = TRUE;
 	data->authorized = FALSE;
 
-	/* Check and register thet key with the context, frees keydata */
-	ssh_key_from_data (closure->source, closure, data);
+	found_key_data (closure, data);
 	return TRUE;
 }
 
@@ -547,8 +802,7 @@ on_load_found_public_key (SeahorseSSHKeyData *data,
 	data->privfile = g_strdup (closure->privfile);
 	data->partial = FALSE;
 
-	/* Check and register thet key with the context, frees keydata */
-	closure->last_key = ssh_key_from_data (closure->source, closure, data);
+	found_key_data (closure, data);
 	return TRUE;
 }
 
@@ -580,6 +834,30 @@ load_key_for_private_file (SeahorseSSHSource *self,
 	closure->privfile = closure->pubfile = NULL;
 }
 
+static void
+load_keys_for_public_file (source_load_closure *closure,
+                           const gchar *pubfile,
+                           SeahorseSSHPublicKeyParsed public_cb)
+{
+	GError *error = NULL;
+
+	closure->privfile = NULL;
+	closure->pubfile = g_strdup (pubfile);
+
+	if (g_file_test (closure->pubfile, G_FILE_TEST_EXISTS)) {
+		seahorse_ssh_key_data_parse_file (closure->pubfile, public_cb,
+		                                  NULL, closure, &error);
+		if (error != NULL) {
+			g_warning ("couldn't read SSH file: %s (%s)",
+			           closure->pubfile, error->message);
+			g_clear_error (&error);
+		}
+	}
+
+	g_free (closure->pubfile);
+	closure->pubfile = NULL;
+}
+
 static SeahorseSSHKey *
 seahorse_ssh_source_load_one_sync (SeahorseSSHSource *self,
                                    const gchar *privfile)
@@ -589,6 +867,7 @@ seahorse_ssh_source_load_one_sync (SeahorseSSHSource *self,
 
 	closure = g_new0 (source_load_closure, 1);
 	closure->source = g_object_ref (self);
+	g_mutex_init (&closure->mutex);
 
 	load_key_for_private_file (self, closure, privfile);
 
@@ -598,98 +877,291 @@ seahorse_ssh_source_load_one_sync (SeahorseSSHSource *self,
 	return key;
 }
 
+/* Reloads all the keys in an authorized_keys or other keys file */
 static void
-seahorse_ssh_source_load_async (SeahorsePlace *place,
-                                GCancellable *cancellable,
-                                GAsyncReadyCallback callback,
-                                gpointer user_data)
+reload_public_file (SeahorseSSHSource *self,
+                    const gchar *pubfile,
+                    SeahorseSSHPublicKeyParsed public_cb)
 {
-	SeahorseSSHSource *self = SEAHORSE_SSH_SOURCE (place);
-	GSimpleAsyncResult *res;
 	source_load_closure *closure;
-	GError *error = NULL;
-	const gchar *filename;
-	gchar *privfile;
-	GDir *dir;
 
-	res = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
-	                                 seahorse_ssh_source_load_async);
 	closure = g_new0 (source_load_closure, 1);
 	closure->source = g_object_ref (self);
+	g_mutex_init (&closure->mutex);
+	closure->loaded = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
-	/* Since we can find duplicate keys, limit them with this hash */
-	closure->loaded = g_hash_table_new_full (g_str_hash, g_str_equal,
-	                                         g_free, NULL);
+	/* The keys that were loaded from this file */
+	closure->checks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	if (g_hash_table_lookup (self->priv->keys, pubfile))
+		g_hash_table_insert (closure->checks, g_strdup (pubfile), "PRESENT");
 
-	/* Keys that currently exist, so we can remove any that disappeared */
-	closure->checks = load_present_keys (self);
+	load_keys_for_public_file (closure, pubfile, public_cb);
 
-	g_simple_async_result_set_op_res_gpointer (res, closure, source_load_free);
+	g_hash_table_foreach (closure->checks, (GHFunc)remove_key_from_context, self);
+	source_load_free (closure);
+}
 
-	/* Schedule a dummy refresh. This blocks all monitoring for a while */
-	cancel_scheduled_refresh (self);
-	self->priv->scheduled_refresh = g_timeout_add (500, (GSourceFunc)scheduled_dummy, self);
-	g_debug ("scheduled a dummy refresh");
+/* Reloads only the keys affected by a changed file */
+static void
+reload_changed_file (SeahorseSSHSource *self,
+                     const gchar *path)
+{
+	SeahorseSSHKey *key;
+	gchar *privfile;
 
-	/* List the .ssh directory for private keys */
-	dir = g_dir_open (self->priv->ssh_homedir, 0, &error);
-	if (dir == NULL) {
-		g_simple_async_result_take_error (res, error);
-		g_simple_async_result_complete_in_idle (res);
-		g_object_unref (res);
+	if (ends_with (path, AUTHORIZED_KEYS_FILE)) {
+		reload_public_file (self, path, on_load_found_authorized_key);
+		return;
+	} else if (ends_with (path, OTHER_KEYS_FILE)) {
+		reload_public_file (self, path, on_load_found_other_key);
 		return;
 	}
 
-	/* For each private key file */
-	for(;;) {
-		filename = g_dir_read_name (dir);
-		if (filename == NULL)
-			break;
+	/* Either a private key, or the public key next to it */
+	if (ends_with (path, ".pub"))
+		privfile = g_strndup (path, strlen (path) - 4);
+	else
+		privfile = g_strdup (path);
+
+	key = g_hash_table_lookup (self->priv->keys, privfile);
+	if (seahorse_ssh_source_load_one_sync (self, privfile) == NULL && key != NULL)
+		seahorse_ssh_source_remove_object (self, key);
 
-		privfile = g_build_filename (self->priv->ssh_homedir, filename, NULL);
-		load_key_for_private_file (self, closure, privfile);
+	g_free (privfile);
+}
+
+static gboolean
+scheduled_reload (gpointer user_data)
+{
+	SeahorseSSHSource *self = SEAHORSE_SSH_SOURCE (user_data);
+	GHashTableIter iter;
+	const gchar *path;
+	GHashTable *changed;
+
+	g_debug ("reloading changed files now");
+	self->priv->scheduled_reload = 0;
+
+	/* Files that change while we're reloading get scheduled again */
+	changed = self->priv->changed_files;
+	self->priv->changed_files = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                                   g_free, NULL);
+
+	g_hash_table_iter_init (&iter, changed);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&path, NULL))
+		reload_changed_file (self, path);
+
+	g_hash_table_destroy (changed);
+	return FALSE; /* don't run again */
+}
+
+/*
+ * Called from the loading thread for each file in the directory. Uses
+ * stat to skip anything that can't be a private key without reading it,
+ * and skips keys whose files haven't changed since the last load.
+ */
+static void
+load_key_for_directory_entry (source_load_closure *closure,
+                              int dirfd,
+                              const gchar *filename)
+{
+	KeyFileStamp stamp;
+	KeyFileStamp *prev;
+	struct stat sb;
+	gchar *privfile;
+	gchar *pubname;
+	GError *error = NULL;
+	int fd;
+
+	/* Public keys are loaded along with their private key */
+	if (g_str_has_suffix (filename, ".pub"))
+		return;
+
+	memset (&stamp, 0, sizeof (stamp));
+
+	/* Only regular files of a sensible size can be private keys */
+	if (fstatat (dirfd, filename, &sb, 0) != 0 || !S_ISREG (sb.st_mode) ||
+	    sb.st_size < PRIVATE_KEY_MIN_SIZE || sb.st_size > PRIVATE_KEY_MAX_SIZE)
+		return;
+	file_stamp_for_stat (&stamp.privfile, &sb);
+
+	/* And we only load them when they have a public key next to them */
+	pubname = g_strconcat (filename, ".pub", NULL);
+	if (fstatat (dirfd, pubname, &sb, 0) != 0 || !S_ISREG (sb.st_mode)) {
+		g_free (pubname);
+		return;
+	}
+	file_stamp_for_stat (&stamp.pubfile, &sb);
+	g_free (pubname);
+
+	privfile = g_build_filename (closure->homedir, filename, NULL);
+
+	/* Nothing changed since the last load */
+	prev = g_hash_table_lookup (closure->stamps, privfile);
+	if (prev && memcmp (&prev->privfile, &stamp.privfile, sizeof (FileStamp)) == 0 &&
+	    memcmp (&prev->pubfile, &stamp.pubfile, sizeof (FileStamp)) == 0) {
+		g_hash_table_insert (closure->new_stamps, g_strdup (privfile),
+		                     g_memdup (prev, sizeof (KeyFileStamp)));
+		if (prev->is_key) {
+			g_mutex_lock (&closure->mutex);
+			g_ptr_array_add (closure->unchanged, privfile);
+			g_mutex_unlock (&closure->mutex);
+		} else {
+			g_free (privfile);
+		}
+		return;
+	}
+
+	fd = openat (dirfd, filename, O_RDONLY | O_NOCTTY);
+	if (fd == -1) {
+		g_warning ("couldn't open file to check for SSH key: %s: %s",
+		           privfile, g_strerror (errno));
 		g_free (privfile);
+		return;
 	}
 
-	g_dir_close (dir);
+	stamp.is_key = check_fd_for_ssh_private (closure->source, fd, privfile);
+	close (fd);
 
-	/* Now load the authorized file */
-	closure->privfile = NULL;
-	closure->pubfile = seahorse_ssh_source_file_for_public (self, TRUE);
+	g_hash_table_insert (closure->new_stamps, g_strdup (privfile),
+	                     g_memdup (&stamp, sizeof (KeyFileStamp)));
 
-	if (g_file_test (closure->pubfile, G_FILE_TEST_EXISTS)) {
-		seahorse_ssh_key_data_parse_file (closure->pubfile, on_load_found_authorized_key,
+	if (stamp.is_key) {
+		closure->privfile = privfile;
+		closure->pubfile = g_strconcat (privfile, ".pub", NULL);
+		seahorse_ssh_key_data_parse_file (closure->pubfile, on_load_found_public_key,
 		                                  NULL, closure, &error);
 		if (error != NULL) {
 			g_warning ("couldn't read SSH file: %s (%s)",
 			           closure->pubfile, error->message);
 			g_clear_error (&error);
 		}
+		g_free (closure->pubfile);
+		closure->pubfile = closure->privfile = NULL;
 	}
 
-	g_free (closure->pubfile);
-	closure->pubfile = NULL;
+	g_free (privfile);
+}
 
-	/* Load the other keys file */
-	closure->privfile = NULL;
-	closure->pubfile = seahorse_ssh_source_file_for_public (self, FALSE);
-	if (g_file_test (closure->pubfile, G_FILE_TEST_EXISTS)) {
-		seahorse_ssh_key_data_parse_file (closure->pubfile, on_load_found_other_key,
-		                                  NULL, closure, &error);
-		if (error != NULL) {
-			g_warning ("couldn't read SSH file: %s (%s)",
-			           closure->pubfile, error->message);
-			g_clear_error (&error);
+/* Drops the load thread's reference to the result on the main loop */
+static gboolean
+on_idle_release_load (gpointer data)
+{
+	return FALSE; /* The destroy notify does the work */
+}
+
+/*
+ * Runs in its own thread. Only reads files and parses them, all the keys
+ * are created and registered on the main loop.
+ */
+static gpointer
+source_load_thread (gpointer data)
+{
+	GSimpleAsyncResult *res = G_SIMPLE_ASYNC_RESULT (data);
+	source_load_closure *closure = g_simple_async_result_get_op_res_gpointer (res);
+	GError *error = NULL;
+	const gchar *filename;
+	int dirfd = -1;
+	GDir *dir;
+
+	/* List the .ssh directory for private keys */
+	dir = g_dir_open (closure->homedir, 0, &error);
+	if (dir != NULL) {
+		dirfd = open (closure->homedir, O_RDONLY | O_DIRECTORY);
+		if (dirfd == -1) {
+			g_set_error (&error, G_FILE_ERROR, g_file_error_from_errno (errno),
+			             "Couldn't open directory '%s': %s", closure->homedir,
+			             g_strerror (errno));
+			g_dir_close (dir);
+			dir = NULL;
 		}
 	}
 
-	g_free (closure->pubfile);
-	closure->pubfile = NULL;
+	if (dir == NULL) {
+		g_mutex_lock (&closure->mutex);
+		closure->error = error;
+		g_mutex_unlock (&closure->mutex);
+		queue_batch_of_keys (res, closure, TRUE);
+		g_idle_add_full (G_PRIORITY_LOW, on_idle_release_load, res, g_object_unref);
+		return NULL;
+	}
 
-	/* Clean up and done */
-	g_hash_table_foreach (closure->checks, (GHFunc)remove_key_from_context, self);
+	/* For each private key file */
+	while (!g_cancellable_is_cancelled (closure->cancellable)) {
+		filename = g_dir_read_name (dir);
+		if (filename == NULL)
+			break;
+
+		load_key_for_directory_entry (closure, dirfd, filename);
+
+		if (closure->batch->len >= DEFAULT_LOAD_BATCH)
+			queue_batch_of_keys (res, closure, FALSE);
+	}
+
+	close (dirfd);
+	g_dir_close (dir);
+
+	/* Now load the authorized file, and then the other keys file */
+	if (!g_cancellable_is_cancelled (closure->cancellable))
+		load_keys_for_public_file (closure, closure->authorized_file,
+		                           on_load_found_authorized_key);
+	if (!g_cancellable_is_cancelled (closure->cancellable))
+		load_keys_for_public_file (closure, closure->other_file,
+		                           on_load_found_other_key);
+
+	queue_batch_of_keys (res, closure, TRUE);
+
+	/*
+	 * The merges can complete and drop their references before we get
+	 * here, so never release the last reference on this thread.
+	 */
+	g_idle_add_full (G_PRIORITY_LOW, on_idle_release_load, res, g_object_unref);
+	return NULL;
+}
+
+static void
+seahorse_ssh_source_load_async (SeahorsePlace *place,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+	SeahorseSSHSource *self = SEAHORSE_SSH_SOURCE (place);
+	GSimpleAsyncResult *res;
+	source_load_closure *closure;
+	GThread *thread;
+
+	res = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+	                                 seahorse_ssh_source_load_async);
+	closure = g_new0 (source_load_closure, 1);
+	closure->source = g_object_ref (self);
+	closure->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	closure->homedir = g_strdup (self->priv->ssh_homedir);
+	closure->authorized_file = seahorse_ssh_source_file_for_public (self, TRUE);
+	closure->other_file = seahorse_ssh_source_file_for_public (self, FALSE);
+	closure->batch = g_ptr_array_new ();
+	closure->batches = g_queue_new ();
+	closure->unchanged = g_ptr_array_new_with_free_func (g_free);
+	closure->stamps = load_present_stamps (self);
+	closure->new_stamps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	g_mutex_init (&closure->mutex);
+
+	/* Since we can find duplicate keys, limit them with this hash */
+	closure->loaded = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                         g_free, NULL);
+
+	/* Keys that currently exist, so we can remove any that disappeared */
+	closure->checks = load_present_keys (self);
+
+	g_simple_async_result_set_op_res_gpointer (res, closure, source_load_free);
+
+	/* Schedule a dummy refresh. This blocks all monitoring for a while */
+	cancel_scheduled_refresh (self);
+	self->priv->scheduled_refresh = g_timeout_add (500, (GSourceFunc)scheduled_dummy, self);
+	g_debug ("scheduled a dummy refresh");
+
+	/* The loading thread owns this reference until it's done */
+	thread = g_thread_new ("ssh-load", source_load_thread, g_object_ref (res));
+	g_thread_unref (thread);
 
-	g_simple_async_result_complete_in_idle (res);
 	g_object_unref (res);
 }
 
@@ -905,6 +1377,12 @@ seahorse_ssh_source_file_for_algorithm (SeahorseSSHSource *ssrc, guint algo)
     case SSH_ALGO_RSA:
         pref = "id_rsa";
         break;
+    case SSH_ALGO_ECDSA:
+        pref = "id_ecdsa";
+        break;
+    case SSH_ALGO_ED25519:
+        pref = "id_ed25519";
+        break;
     case SSH_ALGO_UNK:
         pref = "id_unk";
         break;
@@ -80,12 +80,45 @@ on_upload_input_changed (GtkWidget *dummy, SeahorseWidget *swidget)
     g_free (t);
 }
 
+static void 
+on_upload_many_complete (GObject *source,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+	GError *error = NULL;
+
+	if (!seahorse_ssh_op_upload_many_finish (SEAHORSE_SSH_SOURCE (source), result, &error))
+		seahorse_util_handle_error (&error, NULL, _("Couldn't configure Secure Shell keys on remote computer."));
+}
+
+/* Several hosts can be entered, separated by commas or spaces */
+static gchar **
+split_hosts (const gchar *hosts)
+{
+    gchar **split, **h;
+    GPtrArray *result;
+
+    result = g_ptr_array_new ();
+    split = g_strsplit_set (hosts, ", \t", -1);
+    for (h = split; *h; h++) {
+        if ((*h)[0])
+            g_ptr_array_add (result, g_strdup (*h));
+    }
+    g_strfreev (split);
+
+    g_ptr_array_add (result, NULL);
+    return (gchar **)g_ptr_array_free (result, FALSE);
+}
+
 static void
 upload_keys (SeahorseWidget *swidget)
 {
     GtkWidget *widget;
+    GtkWindow *parent;
     const gchar *cuser, *chost;
     gchar *user, *host, *port;
+    gchar *default_user;
+    gchar **hosts;
     GList *keys;
     GCancellable *cancellable;
 
@@ -101,32 +134,36 @@ upload_keys (SeahorseWidget *swidget)
     chost = (gchar*)gtk_entry_get_text (GTK_ENTRY (widget));
     g_return_if_fail (chost && g_utf8_validate (chost, -1, NULL));
     
-    user = g_strdup (cuser);
-    host = g_strdup (chost);
+    hosts = split_hosts (chost);
+    default_user = g_strdup (cuser);
+    seahorse_util_string_trim_whitespace (default_user);
 
-    /* Port is anything past a colon */
-    port = strchr (host, ':');
-    if (port) {
-        *port = 0;
-        port++;
-        
-        /* Trim and check */
-        seahorse_util_string_trim_whitespace (port);
-        if (!port[0])
-            port = NULL;
-    }
-
-    seahorse_util_string_trim_whitespace (host);
-    seahorse_util_string_trim_whitespace (user);
+    /* This dialog goes away right after, so prompt over the window it was for */
+    widget = GTK_WIDGET (seahorse_widget_get_widget (swidget, swidget->name));
+    parent = gtk_window_get_transient_for (GTK_WINDOW (widget));
 
     cancellable = g_cancellable_new ();
 
+    /* Upload to many computers at once */
+    if (g_strv_length (hosts) > 1) {
+        seahorse_ssh_op_upload_many_async (SEAHORSE_SSH_SOURCE (seahorse_object_get_place (keys->data)),
+                                           keys, (const gchar **)hosts, default_user, parent,
+                                           cancellable, on_upload_many_complete, NULL);
+
     /* Start an upload process */
-    seahorse_ssh_op_upload_async (SEAHORSE_SSH_SOURCE (seahorse_object_get_place (keys->data)),
-                                  keys, user, host, port, NULL, cancellable, on_upload_complete, NULL);
+    } else {
+        seahorse_ssh_op_parse_target (hosts[0] ? hosts[0] : chost, default_user,
+                                      &user, &host, &port);
+        seahorse_ssh_op_upload_async (SEAHORSE_SSH_SOURCE (seahorse_object_get_place (keys->data)),
+                                      keys, user, host, port, parent, cancellable,
+                                      on_upload_complete, NULL);
+        g_free (port);
+        g_free (host);
+        g_free (user);
+    }
 
-    g_free (host);
-    g_free (user);
+    g_free (default_user);
+    g_strfreev (hosts);
 
     seahorse_progress_show (cancellable, _("Configuring Secure Shell Keys..."), FALSE);
     g_object_unref (cancellable);